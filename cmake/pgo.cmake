@@ -0,0 +1,39 @@
+# Profile-guided build of Slots, run from the project folder:
+#
+#   cmake -D BUILD_DIR=build -P cmake/pgo.cmake
+#
+# Configures BUILD_DIR for an instrumented build, runs the headless training scenario,
+# then configures the same directory to use the collected profile and builds Slots again.
+# CONFIG (Release by default) and SPINS are optional; anything else comes from the cache.
+
+cmake_minimum_required(VERSION 3.19)
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+
+if (NOT BUILD_DIR)
+	set(BUILD_DIR "${SOURCE_DIR}/build")
+endif()
+get_filename_component(BUILD_DIR "${BUILD_DIR}" ABSOLUTE BASE_DIR "${SOURCE_DIR}")
+
+if (NOT CONFIG)
+	set(CONFIG Release)
+endif()
+
+set(STAGE_OPTIONS -DCMAKE_BUILD_TYPE=${CONFIG})
+if (SPINS)
+	list(APPEND STAGE_OPTIONS -DSLOTS_PGO_SPINS=${SPINS})
+endif()
+
+# a profile of an older build would be mixed into the new one
+file(REMOVE_RECURSE "${BUILD_DIR}/pgo")
+
+message(STATUS "PGO: instrumented build")
+execute_process(COMMAND ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${BUILD_DIR} ${STAGE_OPTIONS} -DSLOTS_PGO=GENERATE COMMAND_ERROR_IS_FATAL ANY)
+execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --config ${CONFIG} --target Slots COMMAND_ERROR_IS_FATAL ANY)
+
+message(STATUS "PGO: training")
+execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --config ${CONFIG} --target pgo-train COMMAND_ERROR_IS_FATAL ANY)
+
+message(STATUS "PGO: optimized build")
+execute_process(COMMAND ${CMAKE_COMMAND} -S ${SOURCE_DIR} -B ${BUILD_DIR} ${STAGE_OPTIONS} -DSLOTS_PGO=USE COMMAND_ERROR_IS_FATAL ANY)
+execute_process(COMMAND ${CMAKE_COMMAND} --build ${BUILD_DIR} --config ${CONFIG} --target Slots COMMAND_ERROR_IS_FATAL ANY)
\ No newline at end of file
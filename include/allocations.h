@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef ALLOCATIONS_H
+#define ALLOCATIONS_H
+
+#include "bindings.h"
+
+namespace slots::allocations
+{
+	// parts of one frame, as the loops in main go through them
+	enum class phase : Uint8
+	{
+		other, events, update, publish, prepare, draw, present,
+		last
+	};
+
+	// frames without loading, resizing or other one-off work before a thread counts as steady
+	static constexpr size_t warmup = 120;
+
+#ifdef SLOTS_TRACK_ALLOCATIONS
+	// Debug builds with SLOTS_TRACK_ALLOCATIONS replace the global operator new and delete.
+	// Only threads that called track() are counted, per frame and per phase; once such a thread
+	// is steady, every allocation also records its call site, and the frame that allocated
+	// aborts the program after printing them.
+
+	void track(const char* _thread);
+	void enter(phase _phase);
+	auto current() -> phase;
+
+	// closes a frame of the calling thread; `_settled` is false for frames that loaded textures,
+	// handled a resize or did any other work that is allowed to allocate
+	void frame(bool _settled = true);
+#else
+	inline void track(const char* _thread) {}
+	inline void enter(phase _phase) {}
+	inline auto current() -> phase { return phase::other; }
+	inline void frame(bool _settled = true) {}
+#endif
+
+	// switches the phase of the calling thread for the lifetime of the scope
+	class Phase
+	{
+		phase previous;
+
+	public:
+		Phase(phase _phase) : previous(current())
+		{
+			enter(_phase);
+		}
+
+		~Phase()
+		{
+			enter(previous);
+		}
+
+		Phase(const Phase&) = delete;
+		auto operator=(const Phase&) -> Phase& = delete;
+	};
+}
+
+#endif
\ No newline at end of file
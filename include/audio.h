@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include "bindings.h"
+#include "utility.h"
+
+#include <string_view>
+#include <vector>
+#include <array>
+
+namespace slots::audio
+{
+	// Samples are decoded and converted to the device format once, before playback starts.
+	// The frame loop only pushes commands into a lock-free ring; the SDL audio callback
+	// drains it and mixes, so playing a sound never allocates, locks or waits.
+	class Mixer
+	{
+	public:
+		using sound_t = size_t;
+
+		static constexpr int    frequency = 48000;
+		static constexpr Uint8  channels  = 2;
+		static constexpr Uint16 samples   = 256; // ~5 ms per callback at 48 kHz
+
+		static constexpr size_t voices_count = 16;
+
+	private:
+		struct Command
+		{
+			enum class kind : Uint8
+			{
+				play, stop,
+			};
+
+			kind    type  = kind::play;
+			sound_t sound = 0;
+			bool    loop  = false;
+		};
+
+		struct Voice
+		{
+			const std::vector<float>* pcm = nullptr;
+
+			sound_t sound    = 0;
+			size_t  position = 0;
+			bool    loop     = false;
+		};
+
+		sdl::AudioDeviceID device = 0;
+		sdl::AudioSpec     spec   = {};
+
+		bool initialized = false;
+		bool started     = false;
+
+		std::vector<std::vector<float>> sounds;
+		std::array<Voice, voices_count> voices;
+
+		util::Ring<Command, 64> commands;
+
+		static void callback(void* _userdata, Uint8* _stream, int _length);
+
+		void apply(const Command& _command);
+		void mix(float* _stream, size_t _count);
+
+	public:
+		Mixer() = default;
+		~Mixer();
+
+		Mixer(const Mixer&) = delete;
+		auto operator=(const Mixer&) -> Mixer& = delete;
+
+		bool open();
+		// only before start(); later sounds are refused
+		void add(std::string_view _filename);
+		void start();
+
+		bool play(sound_t _sound, bool _loop = false);
+		bool stop(sound_t _sound);
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "bindings.h"
+#include "graphics.h"
+#include "game.h"
+
+#include <cstdio>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+namespace slots::bench
+{
+	enum class scenario : Uint8
+	{
+		idle,   // nothing is pressed, the loop waits for input as it does in the hall
+		spin,   // start is pressed whenever it is active, so the reels hardly ever stand
+		reward, // the largest reward the cabinet can show stays on screen
+		last
+	};
+
+	static constexpr size_t scenarios_count = static_cast<size_t>(scenario::last);
+
+	auto name(scenario _scenario) -> const char*;
+
+	// CPU time of the whole process so far, every thread included, in seconds
+	auto cpu() -> double;
+
+	// one combination of the matrix
+	struct Case
+	{
+		scenario    type     = scenario::idle;
+		const char* cabinet  = nullptr;
+		sdl::Point  size     = {};
+		bool        software = true;
+		// threads the loop plays on: 1 runs serial(), 2 runs parallel() with its simulation thread
+		size_t      threads  = 1;
+	};
+
+	struct Result
+	{
+		bool ran = false; // the renderer could be created and the scenario ran to its end
+
+		Uint64 frames  = 0; // presented while measuring
+		double seconds = 0; // wall time measured
+		double cpu     = 0; // process CPU time over the same stretch
+		Uint64 calls   = 0; // SDL draw calls over the same stretch
+
+		// between consecutive presents, in milliseconds
+		double p50 = 0;
+		double p99 = 0;
+		double max = 0;
+	};
+
+	// Plays one case through the loop it names: a warmup for loading and prescaling, then `duration`
+	// of measurement, after which it pushes SDL_QUIT. Frame times are gathered only between presents,
+	// the CPU time and the draw calls of the process over the whole stretch.
+	class Run : public Script
+	{
+	public:
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr auto   warmup        = std::chrono::milliseconds(500);
+		static constexpr size_t samples_count = 1 << 16; // newest frame times behind the percentiles
+
+	private:
+		const Case              test;
+		const clock_t::duration duration;
+		const graphics::Frame*  frame = nullptr;
+
+		Presser starting;
+
+		Result result;
+
+		std::vector<float> samples; // milliseconds, a ring
+		Uint64             sampled = 0;
+
+		clock_t::time_point started = {};
+		clock_t::time_point begun   = {}; // of the measurement, once the warmup is over
+		clock_t::time_point last    = {};
+
+		double cpu_begun   = 0;
+		Uint64 calls_begun = 0;
+		bool   measuring   = false;
+
+		// read by drive(), which the parallel loop calls on the simulation thread
+		std::atomic<bool> finished = {false};
+
+		void finish(clock_t::time_point _now);
+
+	public:
+		Run(const Case& _case, clock_t::duration _duration);
+
+		// right before the loop, with the game begun
+		void start(Game& _game, const graphics::Frame& _frame);
+
+		void drive(const Game& _game) override;
+		void woke() override;
+		void presented(env::state _state, const graphics::TexturePool& _texture_pool) override;
+
+		auto outcome() const -> const Result&;
+	};
+
+	// the whole matrix as one JSON document
+	void write(std::FILE* _file, const std::vector<Case>& _cases, const std::vector<Result>& _results, double _duration);
+}
+
+#endif
\ No newline at end of file
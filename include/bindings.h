@@ -20,6 +20,10 @@ namespace sdl
 	using Event         = SDL_Event;
 	using EventType     = SDL_EventType;
 	using WindowEventID = SDL_WindowEventID;
+	using AudioSpec     = SDL_AudioSpec;
+	using AudioDeviceID = SDL_AudioDeviceID;
+	using AudioFormat   = SDL_AudioFormat;
+	using RWops         = SDL_RWops;
 
 	namespace env
 	{
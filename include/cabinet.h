@@ -0,0 +1,168 @@
+#pragma once
+
+#ifndef CABINET_H
+#define CABINET_H
+
+#include "bindings.h"
+#include "lists.h"
+
+#include <iterator>
+#include <tuple>
+#include <array>
+
+namespace slots::cabinet
+{
+	// reel kinematics are Q16 fixed-point: one stop is `unit`, velocities are in stops per frame
+	struct Motion
+	{
+		static constexpr size_t precision = 16;
+		static constexpr Uint32 unit      = Uint32(1) << precision;
+
+		// easing profile, one velocity per gear; gear 0 is standing still
+		static constexpr Uint32 profile[] = {
+			0,
+			unit >> 6,
+			unit >> 5,
+			unit >> 4,
+			unit >> 3,
+			unit >> 2,
+			unit >> 1,
+			unit,
+		};
+		static constexpr size_t top          = std::size(profile) - 1;
+		static constexpr Uint32 acceleration = 4;
+	};
+
+	// Geometry of a cabinet: reels side by side, each showing `_rows` stops of a strip of `_length`.
+	template <size_t _reels, size_t _rows, typename _Motion = Motion, size_t _length = env::reel_length>
+	struct Layout : _Motion
+	{
+		static constexpr size_t reels    = _reels;
+		static constexpr size_t rows     = _rows;
+		static constexpr size_t length   = _length;
+		static constexpr size_t viewable = rows + 1; // one more stop scrolls in above the strip
+		static constexpr size_t target   = rows / 2 + 1; // the middle row, counted with the one above
+		static constexpr size_t clusters = 0; // smallest group of equal cats that pays as a cluster, 0 for none
+	};
+
+	struct C3x3 : Layout<3, 3>
+	{
+		static constexpr const char* name = "3x3";
+		static constexpr auto& paylines = env::paylines_3x3;
+	};
+
+	struct C5x3 : Layout<5, 3>
+	{
+		static constexpr const char* name = "5x3";
+		static constexpr auto& paylines = env::paylines_5x3;
+	};
+
+	struct C5x4 : Layout<5, 4>
+	{
+		static constexpr const char* name = "5x4";
+		static constexpr auto& paylines = env::paylines_5x4;
+	};
+
+	struct C6x5 : Layout<6, 5>
+	{
+		static constexpr const char* name = "6x5";
+		static constexpr auto& paylines = env::paylines_6x5;
+		static constexpr size_t clusters = 8;
+	};
+
+	// every variant compiled into the game; the first one is the default
+	using variants = std::tuple<C5x3, C3x3, C5x4, C6x5>;
+
+	static constexpr auto fallback = std::tuple_element_t<0, variants>::name;
+
+	template <typename... _Configs>
+	constexpr auto list(std::tuple<_Configs...>*) -> std::array<const char*, sizeof...(_Configs)>
+	{
+		return {_Configs::name...};
+	}
+
+	static constexpr auto names = list((variants*)nullptr);
+
+	// splitmix64, a generator simple enough to run at compile time
+	constexpr auto mix(Uint64& _state) -> Uint64
+	{
+		Uint64 z = (_state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	template <typename _Config>
+	using strip_t = std::array<Uint8, _Config::length>;
+
+	// The fixed strip of reel `_reel`: env::occurrences of every cat, shuffled from env::strip_seed,
+	// the size of the cabinet and the reel. Weighted stops over it give the same odds in every run.
+	template <typename _Config>
+	constexpr auto strip(size_t _reel) -> strip_t<_Config>
+	{
+		strip_t<_Config> strip = {};
+
+		size_t stop = 0;
+		for (size_t symbol = 0; symbol < env::occurrences.size(); symbol++)
+			for (unsigned i = 0; i < *(env::occurrences.begin() + symbol); i++)
+				strip[stop++] = (Uint8)symbol;
+
+		Uint64 state = env::strip_seed ^ ((Uint64)_Config::reels << 48) ^ ((Uint64)_Config::rows << 40) ^ (Uint64)_reel;
+		for (size_t i = _Config::length - 1; i > 0; i--)
+		{
+			size_t j = (size_t)(mix(state) % (i + 1));
+			Uint8 swapped = strip[i];
+			strip[i] = strip[j];
+			strip[j] = swapped;
+		}
+		return strip;
+	}
+
+	template <typename _Config>
+	constexpr auto strips() -> std::array<strip_t<_Config>, _Config::reels>
+	{
+		std::array<strip_t<_Config>, _Config::reels> strips = {};
+		for (size_t reel = 0; reel < _Config::reels; reel++)
+			strips[reel] = strip<_Config>(reel);
+		return strips;
+	}
+
+	// whether every strip holds exactly env::occurrences of each cat, so the odds are the ones the weights promise
+	template <typename _Config>
+	constexpr bool composed(const std::array<strip_t<_Config>, _Config::reels>& _strips)
+	{
+		if (env::occurrences.size() != env::cats.size())
+			return false;
+
+		size_t total = 0;
+		for (unsigned count : env::occurrences)
+			total += count;
+		if (total != _Config::length)
+			return false;
+
+		for (const auto& strip : _strips)
+			for (size_t symbol = 0; symbol < env::occurrences.size(); symbol++)
+			{
+				size_t count = 0;
+				for (Uint8 stop : strip)
+					count += stop == symbol;
+				if (count != *(env::occurrences.begin() + symbol))
+					return false;
+			}
+		return true;
+	}
+
+	// FNV-1a over every stop of every strip; a journal record carries it, so its stops can be
+	// looked up on the strips they were drawn from even after the seed or the weights change
+	template <typename _Config>
+	constexpr auto fingerprint(const std::array<strip_t<_Config>, _Config::reels>& _strips) -> Uint64
+	{
+		Uint64 hash = 0xCBF29CE484222325ull;
+		for (const auto& strip : _strips)
+			for (Uint8 stop : strip)
+				hash = (hash ^ stop) * 0x100000001B3ull;
+		return hash;
+	}
+}
+
+#endif
\ No newline at end of file
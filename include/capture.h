@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "bindings.h"
+#include "graphics.h"
+#include "utility.h"
+
+#include <string_view>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <array>
+
+namespace slots::capture
+{
+	// Keeps the last `window` of presented frames, downscaled, and writes them as a Y4M clip
+	// whenever a mark arrives, e.g. on every entry into the Show state. A clip starts where the
+	// previous one ended, so frames are never written twice, and the oldest clips of the directory
+	// are removed once together they exceed `retained` bytes.
+	//
+	// SDL2 has no asynchronous readback, so the copy out of the back buffer is the one part done
+	// on the render thread: at `rate` frames a second, into one of a few preallocated buffers.
+	// Scaling, colour conversion, the history ring and file output all live on the worker thread.
+	// When every buffer is still waiting for the worker, the frame is not captured rather than waited for.
+	class Recorder : public graphics::Observer
+	{
+	public:
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr size_t rate    = 10; // pictures kept per second
+		static constexpr int    scale   = 2;  // of the logical frame size to the encoded one
+		static constexpr size_t staging = 4;  // readbacks the worker may be behind by
+
+		static constexpr Uint64 retained = Uint64(1) << 30; // bytes of clips kept in the directory
+
+		static constexpr auto window   = std::chrono::seconds(30);
+		static constexpr auto period   = std::chrono::duration_cast<clock_t::duration>(std::chrono::seconds(1)) / rate;
+		static constexpr auto capacity = (size_t)window.count() * rate;
+
+	private:
+		struct Readback
+		{
+			std::vector<Uint32> pixels; // ARGB8888, tightly packed
+			sdl::Point          size = {};
+			clock_t::time_point time = {};
+		};
+
+		// planar YUV 4:2:0, full range
+		struct Picture
+		{
+			std::vector<Uint8>  planes;
+			clock_t::time_point time = {};
+		};
+
+		std::string directory;
+		sdl::Point  size = {}; // of every picture, even on both sides
+
+		std::array<Readback, staging>       readbacks;
+		util::Ring<size_t, staging>         available; // worker to render thread
+		util::Ring<size_t, staging>         filled;    // render thread to worker
+		util::Ring<clock_t::time_point, 16> marks;
+
+		// render thread only
+		size_t              reserved = staging;
+		clock_t::time_point last     = {};
+
+		// worker only
+		std::vector<Picture> pictures; // ring, `next` is the slot written next
+		size_t               next = 0;
+		std::vector<Uint8>   scaled;   // RGB
+		clock_t::time_point  covered = {}; // up to where clips were written
+
+		std::thread       worker;
+		std::atomic<bool> running = {false};
+		util::Wakeup      wakeup; // readbacks, marks or stop for the worker
+
+		void run();
+		void convert(const Readback& _readback);
+		void write(clock_t::time_point _mark);
+		void prune();
+
+	public:
+		Recorder() = default;
+		~Recorder();
+
+		Recorder(const Recorder&) = delete;
+		auto operator=(const Recorder&) -> Recorder& = delete;
+
+		// `_size` is the logical frame size; pictures are that divided by `scale`
+		bool start(std::string_view _directory, sdl::Point _size);
+		void stop();
+
+		void presenting(sdl::Renderer* _renderer) override;
+
+		// writes the history up to now into a new clip
+		void mark();
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#ifndef CRYPTO_H
+#define CRYPTO_H
+
+#include "bindings.h"
+#include "utility.h"
+
+#include <atomic>
+#include <thread>
+#include <array>
+
+namespace slots::crypto
+{
+	// FIPS 180-4 SHA-256, incremental
+	class Sha256
+	{
+	public:
+		static constexpr size_t block_size  = 64;
+		static constexpr size_t digest_size = 32;
+
+		using digest_t = std::array<Uint8, digest_size>;
+
+	private:
+		std::array<Uint32, 8>         state;
+		std::array<Uint8, block_size> block;
+
+		Uint64 length = 0; // bytes fed so far
+
+		void compress(const Uint8* _block);
+
+	public:
+		Sha256();
+
+		void update(const void* _data, size_t _size);
+		auto finish() -> digest_t;
+	};
+
+	// RFC 8439 ChaCha20 keystream, used as a deterministic generator over a secret key
+	class ChaCha20
+	{
+	public:
+		static constexpr size_t key_size   = 32;
+		static constexpr size_t nonce_size = 12;
+		static constexpr size_t block_size = 64;
+
+		using key_t   = std::array<Uint8, key_size>;
+		using nonce_t = std::array<Uint8, nonce_size>;
+		using block_t = std::array<Uint8, block_size>;
+
+	private:
+		std::array<Uint32, 16> state;
+
+	public:
+		ChaCha20(const key_t& _key, const nonce_t& _nonce, Uint32 _counter = 0);
+
+		// the next block of keystream; the block counter advances by one
+		void generate(block_t& _block);
+	};
+
+	// SP 800-90B continuous health tests on 8-bit samples of the entropy source:
+	// the repetition count and the adaptive proportion test, cutoffs for full-entropy bytes at alpha = 2^-20
+	class Health
+	{
+	public:
+		static constexpr size_t repetition_cutoff = 4;
+		static constexpr size_t window            = 512;
+		static constexpr size_t proportion_cutoff = 13;
+
+	private:
+		Uint8  previous = 0;
+		size_t repeated = 0;
+
+		Uint8  reference = 0;
+		size_t position  = 0;
+		size_t matches   = 0;
+
+	public:
+		// false once a sample trips either test
+		bool feed(Uint8 _sample);
+	};
+
+	// fills the buffer from the operating system's CSPRNG
+	bool entropy(Uint8* _buffer, size_t _size);
+
+	// Cryptographically strong words generated ahead of time: a background thread runs ChaCha20,
+	// rekeyed from health-tested OS entropy, and keeps a lock-free ring topped up.
+	// Taking words is a few atomic loads, so a spin start never waits for the generator.
+	// If the entropy source fails a health test the stream stops serving words for good.
+	class Stream
+	{
+	public:
+		static constexpr size_t capacity = 4096;    // words kept ready
+		static constexpr size_t rekey    = 1 << 16; // blocks generated under one key
+
+	private:
+		util::Ring<Uint64, capacity> words;
+
+		std::thread       producer;
+		std::atomic<bool> running = {false};
+		std::atomic<bool> failed  = {false};
+		util::Wakeup      refill; // signalled when words are taken or the stream stops
+
+		Health health;
+
+		bool seed(ChaCha20::key_t& _key);
+		void run();
+
+	public:
+		Stream();
+		~Stream();
+
+		Stream(const Stream&) = delete;
+		auto operator=(const Stream&) -> Stream& = delete;
+
+		// consumer side: at most one thread
+		bool ready(size_t _count) const;
+		bool take(Uint64* _words, size_t _count);
+
+		bool healthy() const;
+	};
+}
+
+#endif
\ No newline at end of file
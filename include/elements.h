@@ -7,49 +7,107 @@
 #include "graphics.h"
 #include "utility.h"
 #include "lists.h"
+#include "evaluation.h"
+#include "cabinet.h"
 
+#include <string_view>
 #include <type_traits>
+#include <memory>
+#include <iterator>
+#include <limits>
 #include <vector>
 #include <array>
 
+namespace slots::layer
+{
+	enum : Uint32
+	{
+		clip, symbols, borders, unclip, frame, buttons, reward,
+	};
+}
+
 namespace slots
 {
-	class Barrel : public graphics::Drawable
+	// One reel of a cabinet. Every size and the motion profile come from `_Config`,
+	// so each variant is compiled with its own constants and no per-frame branching on them.
+	template <typename _Config>
+	class Barrel : public graphics::Rect
 	{
 	public:
-		static constexpr size_t length   = 10;
-		static constexpr size_t strip    = 3;
-		static constexpr size_t viewable = strip + 1;
-		static constexpr size_t target   = 2;
+		using config_t = _Config;
+
+		static constexpr size_t length   = _Config::length;
+		static constexpr size_t strip    = _Config::rows;
+		static constexpr size_t viewable = _Config::viewable;
+		static constexpr size_t target   = _Config::target;
 
 		static constexpr sdl::Color border = {/*.r =*/ 200, /*.g =*/ 200, /*.b =*/ 200, /*.a =*/ 255};
 
-		static constexpr struct {
-			size_t min;
-			size_t max;
-		} segmentation = {
-			/*.min =*/ 0x04,
-			/*.max =*/ 0x80,
-		};
-		static constexpr size_t acceleration = segmentation.min;
+		static constexpr size_t precision = _Config::precision;
+		static constexpr Uint32 unit      = _Config::unit;
+
+		static constexpr const Uint32 (&profile)[std::size(_Config::profile)] = _Config::profile;
+
+		static constexpr size_t top          = _Config::top;
+		static constexpr Uint32 acceleration = _Config::acceleration;
+
+		// every moving gear but the top one passes exactly one stop while braking,
+		// so a reel stops this many stops after the one it starts braking on
+		static constexpr size_t braking = top - 1;
+
+		static constexpr size_t symbols_count = env::cats.size();
+		static_assert(symbols_count <= std::numeric_limits<Uint8>::max(), "symbol ids are stored as bytes");
+		static_assert(length > braking, "the reel has to be longer than the stretch it brakes over");
+
+		static_assert(
+			[]()
+			{
+				for (size_t gear = 1; gear <= top; gear++)
+					if (unit % profile[gear] != 0)
+						return false;
+				return true;
+			}(),
+			"every velocity of the profile must divide a stop evenly"
+		);
 
 	private:
-		using array_t = std::array<std::pair<size_t, graphics::Texture>, length>;
+		using strip_t   = std::array<Uint8, length + viewable - 1>;
+		using glyphs_t  = std::array<const graphics::Source*, symbols_count>;
+		using colors_t  = std::array<sdl::Color, symbols_count>;
+		using handles_t = std::array<graphics::RenderList::handle_t, viewable>;
+
+		// symbol ids of the virtual stops; the first `viewable - 1` are repeated at the end,
+		// so every window of `viewable` stops is contiguous and needs no wrapping
+		strip_t reel;
+
+		// the only per-symbol render state, shared by every stop showing that symbol
+		glyphs_t glyphs;
+		colors_t colors;
+
+		handles_t sprites;
+		handles_t borders;
 
-		array_t symbols;
+		util::Alias stops;
 
-		size_t current   = 0;
-		size_t scrolling = 0;
-		size_t segment   = segmentation.max;
+		size_t current     = 0;
+		size_t destination = 0;
 
-		auto index(size_t _i) const -> size_t;
+		Uint32 offset = 0;
+		size_t gear   = 0;
+
+		auto scrolled() const -> float;
+
+		// first stop of the window, the one scrolling in above the strip
+		auto window() const -> const Uint8*;
 
 	public:
 		Barrel() = default;
 
-		void init(const graphics::TexturePool& _texture_pool) override;
-		void draw(sdl::Renderer* _renderer) const override;
-		void update() override;
+		// `_strip` is the fixed strip of this reel, see cabinet::strip
+		void init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list, const cabinet::strip_t<_Config>& _strip);
+		void update(graphics::RenderList& _list);
+
+		void resolve(Uint64 _entropy);
 
 		void accelerate();
 		void spin();
@@ -58,67 +116,148 @@ namespace slots
 		bool stopped() const;
 		bool accelerated() const;
 		auto symbol() const -> size_t;
+		// symbol in a row of the strip, counted from the top, once the reel stands still
+		auto symbol(size_t _row) const -> size_t;
+		auto stop() const -> size_t;
 
-	private:
-		template <typename _Func, util::require<std::is_invocable_v<_Func, graphics::Texture&>> = 0>
-		void apply(_Func _func);
-		template <typename _Func, util::require<std::is_invocable_v<_Func, const graphics::Texture&>> = 0>
-		void apply(_Func _func) const;
-		template <typename _Func, util::require<std::is_invocable_v<_Func, graphics::Texture&, size_t>> = 0>
-		void apply(_Func _func);
-		template <typename _Func, util::require<std::is_invocable_v<_Func, const graphics::Texture&, size_t>> = 0>
-		void apply(_Func _func) const;
+		// the first invariant of the reel that does not hold, or nothing;
+		// `_landed` also requires it to stand still on the resolved stop
+		auto drift(bool _landed) const -> const char*;
+	};
+
+	// The reels as the states see them, whichever cabinet was chosen at startup.
+	// Each call covers all reels, so the loops over them stay inside one specialized variant.
+	class Reels : public graphics::Rect
+	{
+	public:
+		static constexpr size_t capacity = 8; // most reels any cabinet may have
+
+		using pay_t = Uint64 (*)(size_t _symbol, size_t _count);
+
+		virtual ~Reels() = default;
+
+		virtual auto name() const -> const char* = 0;
+		// cabinet::fingerprint of the strips the stops index
+		virtual auto fingerprint() const -> Uint64 = 0;
+		virtual auto count() const -> size_t = 0;
+		virtual auto rows() const -> size_t = 0;
+
+		virtual void init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list) = 0;
+		virtual void update(graphics::RenderList& _list) = 0;
+
+		// one word per reel
+		virtual void resolve(const Uint64* _entropy) = 0;
+
+		virtual void accelerate() = 0;
+		virtual void spin() = 0;
+		virtual void decelerate() = 0;
+
+		virtual bool stopped() const = 0;
+		virtual auto halted() const -> size_t = 0;
+		virtual bool accelerated() const = 0;
+
+		// paylines and scatters over the window the reels stopped on
+		virtual auto evaluate(pay_t _pay) const -> evaluation::Result = 0;
+		virtual auto stop(size_t _reel) const -> size_t = 0;
+
+		// a broken invariant and the reel it was found on; `what` is empty while every reel is intact
+		struct Drift
+		{
+			size_t      reel = 0;
+			const char* what = nullptr;
+		};
+
+		virtual auto drift(bool _landed) const -> Drift = 0;
 	};
 
-	template <size_t _count>
-	struct Barrels : public graphics::Drawable
+	// the variant of the cabinet with this name, or nothing if it was not compiled in
+	auto reels(std::string_view _cabinet) -> std::unique_ptr<Reels>;
+
+	template <typename _Config>
+	struct Barrels : public Reels
 	{
-		using array_t = std::array<Barrel, _count>;
+		static constexpr size_t reels_count = _Config::reels;
+		static constexpr size_t rows_count  = _Config::rows;
+
+		static_assert(reels_count <= capacity, "too many reels for the entropy and journal records");
+
+		using barrel_t = Barrel<_Config>;
+		using array_t  = std::array<barrel_t, reels_count>;
+		using grid_t   = evaluation::Grid<reels_count, rows_count>;
+
+		// fixed data of the cabinet, the same in every build and every run
+		static constexpr auto strips = cabinet::strips<_Config>();
+
+		static_assert(cabinet::composed<_Config>(strips), "a strip does not hold the stops env::occurrences gives its cats");
+
+		static constexpr Uint64 strips_fingerprint = cabinet::fingerprint<_Config>(strips);
 
 		array_t array;
 
+		evaluation::Lines<reels_count, rows_count>    lines    = _Config::paylines;
+		evaluation::Scatters<reels_count, rows_count> scatters = {env::scatter::symbol, env::scatter::minimum};
+		evaluation::Clusters<reels_count, rows_count> clusters = {_Config::clusters};
+
+		graphics::RenderList::handle_t frame;
+		graphics::RenderList::handle_t clip;
+		graphics::RenderList::handle_t unclip;
+
 		Barrels() = default;
 
-		void init(const graphics::TexturePool& _texture) override
+		auto name() const -> const char* override
 		{
-			for (auto& barrel : array)
-				barrel.init(_texture);
+			return _Config::name;
 		}
-		void draw(sdl::Renderer* _renderer) const override
+		auto fingerprint() const -> Uint64 override
 		{
-			for (auto& barrel : array)
-				barrel.draw(_renderer);
-
-			graphics::Rect rect = *this;
-
-			rect.size.x = size.x * _count;
-			rect.size.y = size.y * Barrel::strip;
-			graphics::draw(_renderer, rect, Barrel::border);
-
-			rect.size.y = size.y;
+			return strips_fingerprint;
+		}
+		auto count() const -> size_t override
+		{
+			return reels_count;
+		}
+		auto rows() const -> size_t override
+		{
+			return rows_count;
+		}
 
-			rect.position.y = position.y - size.y;
-			graphics::fill(_renderer, rect, sdl::env::black);
+		void init(const graphics::TexturePool& _texture, graphics::RenderList& _list) override
+		{
+			for (size_t i = 0; i < reels_count; i++)
+				array[i].init(_texture, _list, strips[i]);
 
-			rect.position.y = position.y + size.y * Barrel::strip;
-			graphics::fill(_renderer, rect, sdl::env::black);
+			frame  = _list.insert(graphics::RenderList::key(layer::frame, 0), graphics::Record::kind::outline);
+			clip   = _list.insert(graphics::RenderList::key(layer::clip, 0), graphics::Record::kind::clip);
+			unclip = _list.insert(graphics::RenderList::key(layer::unclip, 0), graphics::Record::kind::unclip);
+		}
+		void resolve(const Uint64* _entropy) override
+		{
+			for (size_t i = 0; i < reels_count; i++)
+				array[i].resolve(_entropy[i]);
 		}
-		void update() override
+		void update(graphics::RenderList& _list) override
 		{
-			for (size_t i = 0; i < array.size(); i++)
+			for (size_t i = 0; i < reels_count; i++)
 			{
 				(graphics::Rect&)array[i] = *this;
 				array[i].position.x += size.x * i;
-				array[i].update();
+				array[i].update(_list);
 			}
+
+			graphics::Rect rect = *this;
+
+			rect.size.x = size.x * reels_count;
+			rect.size.y = size.y * rows_count;
+			_list.assign(frame, rect, barrel_t::border);
+			_list.assign(clip, rect);
 		}
 
-		static auto speed(size_t _index) -> size_t
+		static constexpr auto speed(size_t _index) -> size_t
 		{
-			constexpr size_t half = _count / 2;
+			constexpr size_t half = reels_count / 2;
 			return (_index % 2 * half) + (_index / 2) + 1;
 		}
-		void accelerate()
+		void accelerate() override
 		{
 			for (auto& barrel : array)
 				if (!barrel.accelerated())
@@ -127,38 +266,73 @@ namespace slots
 					return;
 				}
 		}
-		void spin()
+		void spin() override
 		{
 			for (auto& barrel : array)
 				barrel.spin();
 		}
-		void decelerate()
+		// every reel brakes on its own braking point, so each stops as soon as its stop comes around
+		void decelerate() override
 		{
 			for (auto& barrel : array)
 				if (!barrel.stopped())
-				{
 					barrel.decelerate();
-					return;
-				}
 		}
 
-		bool stopped() const
+		bool stopped() const override
 		{
 			bool result = true;
 			for (const auto& barrel : array)
 				result &= barrel.stopped();
 			return result;
 		}
-		bool accelerated() const
+		auto halted() const -> size_t override
+		{
+			size_t result = 0;
+			for (const auto& barrel : array)
+				result += barrel.stopped();
+			return result;
+		}
+		bool accelerated() const override
 		{
 			bool result = true;
 			for (const auto& barrel : array)
 				result &= barrel.accelerated();
 			return result;
 		}
+
+		auto grid() const -> grid_t
+		{
+			grid_t grid;
+			for (size_t reel = 0; reel < reels_count; reel++)
+				for (size_t row = 0; row < rows_count; row++)
+					grid.set(reel, row, array[reel].symbol(row));
+			return grid;
+		}
+		auto evaluate(pay_t _pay) const -> evaluation::Result override
+		{
+			grid_t grid = this->grid();
+			evaluation::Result result = lines.evaluate(grid, _pay);
+			result += scatters.evaluate(grid, _pay);
+			if constexpr (_Config::clusters != 0)
+				result += clusters.evaluate(grid, _pay);
+			return result;
+		}
+		auto stop(size_t _reel) const -> size_t override
+		{
+			return array[_reel].stop();
+		}
+
+		auto drift(bool _landed) const -> Drift override
+		{
+			for (size_t i = 0; i < reels_count; i++)
+				if (const char* what = array[i].drift(_landed))
+					return {/*.reel =*/ i, /*.what =*/ what};
+			return {};
+		}
 	};
 
-	class Button : public graphics::Drawable
+	class Button : public graphics::Rect
 	{
 		static constexpr size_t type_count = env::buttons.size();
 
@@ -168,6 +342,8 @@ namespace slots
 
 		textures_t textures;
 
+		graphics::RenderList::handle_t sprite;
+
 		size_t type    = 0;
 
 		bool active_  = false;
@@ -178,9 +354,8 @@ namespace slots
 	public:
 		Button() = default;
 
-		void init(const graphics::TexturePool& _texture_pool) override;
-		void draw(sdl::Renderer* _renderer) const override;
-		void update() override;
+		void init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list);
+		void update(graphics::RenderList& _list);
 
 		void set(size_t _type);
 
@@ -195,7 +370,7 @@ namespace slots
 		bool active() const;
 	};
 
-	class Reward : public graphics::Drawable
+	class Reward : public graphics::Rect
 	{
 	public:
 		static constexpr size_t alphabet_size = env::symbols.size();
@@ -203,23 +378,34 @@ namespace slots
 
 		static constexpr size_t multiplier = 13;
 
+		// every digit of the largest value plus the currency sign
+		static constexpr size_t capacity = std::numeric_limits<size_t>::digits10 + 2;
+
 	private:
-		using alphabet_t = std::array<sdl::Texture*, alphabet_size>;
-		using string_t   = std::vector<graphics::Texture>;
+		using alphabet_t = std::array<const graphics::Source*, alphabet_size>;
+		using string_t   = std::array<graphics::Texture, capacity>;
+		using handles_t  = std::array<graphics::RenderList::handle_t, capacity>;
 
 		alphabet_t alphabet;
 		string_t   string;
+		size_t     used = 0; // glyphs of the string, from its front
+		handles_t  sprites;
 
-		void insert(sdl::Texture* _texture);
+		bool shown = false;
+
+		void insert(const graphics::Source* _texture);
 
 	public:
 		size_t value;
 
 		Reward() = default;
 
-		void init(const graphics::TexturePool& _texture_pool) override;
-		void draw(sdl::Renderer* _renderer) const override;
-		void update() override;
+		void init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list);
+		void update(graphics::RenderList& _list);
+		void prefetch(const graphics::TexturePool& _texture_pool) const;
+
+		void show();
+		void hide();
 
 		auto length() const -> size_t;
 	};
@@ -0,0 +1,255 @@
+#pragma once
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "bindings.h"
+#include "utility.h"
+#include "lists.h"
+
+#include <type_traits>
+#include <vector>
+#include <array>
+
+namespace slots::evaluation
+{
+	// branch-free bit count, the same on every compiler
+	constexpr auto popcount(Uint64 _board) -> size_t
+	{
+		_board = _board - ((_board >> 1) & 0x5555555555555555);
+		_board = (_board & 0x3333333333333333) + ((_board >> 2) & 0x3333333333333333);
+		_board = (_board + (_board >> 4)) & 0x0F0F0F0F0F0F0F0F;
+		return (size_t)((_board * 0x0101010101010101) >> 56);
+	}
+
+	// The visible window as one bitboard per symbol: bit `reel * rows + row` is set
+	// on the board of the symbol shown in that cell.
+	template <size_t _reels, size_t _rows>
+	struct Grid
+	{
+		using board_t = Uint64;
+
+		static_assert(_reels * _rows <= 64, "the window has to fit into one 64-bit board");
+
+		static constexpr size_t reels         = _reels;
+		static constexpr size_t rows          = _rows;
+		static constexpr size_t symbols_count = env::cats.size();
+
+		std::array<board_t, symbols_count> boards = {};
+
+		static constexpr auto cell(size_t _reel, size_t _row) -> board_t
+		{
+			return board_t(1) << (_reel * _rows + _row);
+		}
+
+		// every cell of one reel
+		static constexpr auto column(size_t _reel) -> board_t
+		{
+			return ((board_t(1) << _rows) - 1) << (_reel * _rows);
+		}
+
+		// every cell of one row
+		static constexpr auto row(size_t _row) -> board_t
+		{
+			board_t board = 0;
+			for (size_t reel = 0; reel < _reels; reel++)
+				board |= cell(reel, _row);
+			return board;
+		}
+
+		static constexpr auto all() -> board_t
+		{
+			return _reels * _rows == 64 ? ~board_t(0) : (board_t(1) << (_reels * _rows)) - 1;
+		}
+
+		void clear()
+		{
+			boards.fill(0);
+		}
+
+		void set(size_t _reel, size_t _row, size_t _symbol)
+		{
+			boards[_symbol] |= cell(_reel, _row);
+		}
+	};
+
+	struct Result
+	{
+		Uint64 total = 0;
+		Uint64 lines = 0; // bit per paying line, in the order the lines were given
+		Uint64 cells = 0; // every cell that takes part in a win, as a board
+
+		auto operator+=(const Result& _other) -> Result&
+		{
+			total += _other.total;
+			lines |= _other.lines;
+			cells |= _other.cells;
+			return *this;
+		}
+	};
+
+	// Left-to-right paylines. Each line is stored as the masks of its first k cells,
+	// so a line of symbol s pays k of a kind when `(board[s] & prefix[k]) == prefix[k]`.
+	template <size_t _reels, size_t _rows>
+	class Lines
+	{
+	public:
+		using grid_t  = Grid<_reels, _rows>;
+		using board_t = typename grid_t::board_t;
+
+		static constexpr size_t minimum = 3; // shortest run that pays
+
+		static_assert(_reels >= minimum, "a line needs at least as many reels as the shortest paying run");
+
+	private:
+		using prefixes_t = std::array<board_t, _reels + 1>;
+
+		std::vector<prefixes_t> prefixes;
+
+	public:
+		template <size_t _count>
+		Lines(const unsigned char (&_lines)[_count][_reels])
+		{
+			static_assert(_count <= 64, "paying lines are reported as a 64-bit mask");
+
+			prefixes.resize(_count);
+			for (size_t line = 0; line < _count; line++)
+				for (size_t reel = 0; reel < _reels; reel++)
+					prefixes[line][reel + 1] = prefixes[line][reel] | grid_t::cell(reel, _lines[line][reel] % _rows);
+		}
+
+		auto size() const -> size_t
+		{
+			return prefixes.size();
+		}
+
+		// `_pay(symbol, count)` prices one line of `count` equal symbols from the left
+		template <typename _Pay, util::require<std::is_invocable_r_v<Uint64, _Pay, size_t, size_t>> = 0>
+		auto evaluate(const grid_t& _grid, _Pay _pay) const -> Result
+		{
+			Result result;
+
+			for (size_t symbol = 0; symbol < grid_t::symbols_count; symbol++)
+			{
+				board_t board = _grid.boards[symbol];
+
+				// a symbol missing from any of the first reels cannot start a paying run
+				bool reachable = true;
+				for (size_t reel = 0; reel < minimum; reel++)
+					reachable &= (board & grid_t::column(reel)) != 0;
+				if (!reachable)
+					continue;
+
+				for (size_t line = 0; line < prefixes.size(); line++)
+				{
+					const prefixes_t& prefix = prefixes[line];
+					if ((board & prefix[minimum]) != prefix[minimum])
+						continue;
+
+					size_t count = minimum;
+					while (count < _reels && (board & prefix[count + 1]) == prefix[count + 1])
+						count++;
+
+					result.total += _pay(symbol, count);
+					result.lines |= Uint64(1) << line;
+					result.cells |= prefix[count];
+				}
+			}
+
+			return result;
+		}
+	};
+
+	// A scatter pays by how many times its symbol shows anywhere in the window.
+	template <size_t _reels, size_t _rows>
+	class Scatters
+	{
+	public:
+		using grid_t = Grid<_reels, _rows>;
+
+		const size_t symbol;
+		const size_t minimum;
+
+		Scatters(size_t _symbol, size_t _minimum) : symbol(_symbol), minimum(_minimum) {}
+
+		auto count(const grid_t& _grid) const -> size_t
+		{
+			return popcount(_grid.boards[symbol]);
+		}
+
+		template <typename _Pay, util::require<std::is_invocable_r_v<Uint64, _Pay, size_t, size_t>> = 0>
+		auto evaluate(const grid_t& _grid, _Pay _pay) const -> Result
+		{
+			Result result;
+			if (size_t found = count(_grid); found >= minimum)
+			{
+				result.total = _pay(symbol, found);
+				result.cells = _grid.boards[symbol];
+			}
+			return result;
+		}
+	};
+
+	// A cluster is a group of equal symbols joined by edges, across reels and rows.
+	// Groups are grown by shifting the whole board at once instead of visiting cells:
+	// one step moves every cell of the region to all four neighbours in five operations.
+	template <size_t _reels, size_t _rows>
+	class Clusters
+	{
+	public:
+		using grid_t  = Grid<_reels, _rows>;
+		using board_t = typename grid_t::board_t;
+
+		const size_t minimum;
+
+		Clusters(size_t _minimum) : minimum(_minimum) {}
+
+		// the connected part of `_board` that contains `_seed`
+		static auto flood(board_t _seed, board_t _board) -> board_t
+		{
+			// a row step must not wrap into the neighbouring reel
+			constexpr board_t below = grid_t::all() & ~grid_t::row(0);
+			constexpr board_t above = grid_t::all() & ~grid_t::row(_rows - 1);
+
+			board_t region = _seed & _board;
+			for (board_t previous = 0; region != previous;)
+			{
+				previous = region;
+				region |= ((region << 1) & below) | ((region >> 1) & above) | (region << _rows) | (region >> _rows);
+				region &= _board;
+			}
+			return region;
+		}
+
+		template <typename _Pay, util::require<std::is_invocable_r_v<Uint64, _Pay, size_t, size_t>> = 0>
+		auto evaluate(const grid_t& _grid, _Pay _pay) const -> Result
+		{
+			Result result;
+
+			for (size_t symbol = 0; symbol < grid_t::symbols_count; symbol++)
+			{
+				board_t board = _grid.boards[symbol];
+
+				// too few cells of this symbol in the whole window for any group to be large enough
+				if (popcount(board) < minimum)
+					continue;
+
+				while (board)
+				{
+					board_t region = flood(board & (~board + 1), board);
+					board &= ~region;
+
+					if (size_t size = popcount(region); size >= minimum)
+					{
+						result.total += _pay(symbol, size);
+						result.cells |= region;
+					}
+				}
+			}
+
+			return result;
+		}
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "bindings.h"
+#include "graphics.h"
+#include "interface.h"
+#include "states.h"
+
+#include <string_view>
+#include <chrono>
+
+namespace slots
+{
+	// Everything the simulation side of the loop owns: the interface and the state machine.
+	// Only draw() touches the renderer after construction, so the rest can run on its own thread.
+	class Game
+	{
+		graphics::Frame&             frame;
+		const graphics::TexturePool& texture_pool;
+
+		Interface    interface;
+		StateMachine state_machine;
+
+		std::chrono::steady_clock::time_point entered;
+
+	public:
+		// `_cabinet` names one of cabinet::variants
+		Game(graphics::Frame& _frame, const graphics::TexturePool& _texture_pool, std::string_view _cabinet);
+
+		auto audio() -> audio::Mixer&;
+		auto journal() -> journal::Journal&;
+
+		void begin();
+		void handle(const sdl::Event& _event);
+		void update();
+		void draw();
+
+		auto scene() const -> const graphics::RenderList&;
+		// read-only, for scripted drivers that need to know where the buttons are
+		auto view() const -> const Interface&;
+		// shows a fixed reward in whatever state the game is in, until the next spin resets it
+		void showcase(size_t _value);
+		// the scene as it is now has been handed to the renderer
+		void clean();
+		auto state() const -> env::state;
+	};
+
+	// Plays in place of a player, for training, soak runs and benchmarks. Only drive() sees the game:
+	// the serial loop calls every hook on its one thread, the parallel loop calls drive() on the
+	// simulation thread once per tick and the others on the thread that presents.
+	class Script
+	{
+	public:
+		virtual ~Script() = default;
+
+		// before the events of a frame or a tick are handled
+		virtual void drive(const Game& _game) = 0;
+		// whenever the presenting thread wakes up, whether it goes on to present or not
+		virtual void woke() {}
+		// after every present, with the state of the game the presented scene was taken in
+		virtual void presented(env::state _state, const graphics::TexturePool& _texture_pool) = 0;
+	};
+
+	// a left click in the middle of `_button`, pushed into the SDL event queue so it reaches the states
+	// the way a real one does; for scripts
+	void press(const Button& _button);
+
+	// Presses one button for a script whenever it is active and not pressed yet, again only if that press
+	// seems lost. The parallel loop hands a press to the game a tick or more after it was made, and pressing
+	// on every tick until then would flood the SDL event queue.
+	class Presser
+	{
+		size_t waited = 0; // ticks the button stayed unpressed since the last press
+
+	public:
+		static constexpr size_t retry = 64;
+
+		void operator()(const Button& _button);
+	};
+}
+
+#endif
\ No newline at end of file
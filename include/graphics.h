@@ -7,9 +7,13 @@
 #include "utility.h"
 
 #include <map>
+#include <cstdio>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include <string>
 #include <string_view>
-#include <initializer_list>
 
 namespace slots::graphics
 {
@@ -32,91 +36,328 @@ namespace slots::graphics
 		bool contains(sdl::Point _point) const;
 	};
 
+	// Stable slot of the texture pool. Elements and draw records keep pointers to it,
+	// so the texture inside can be replaced between frames without invalidating them.
+	struct Source
+	{
+		struct Level
+		{
+			sdl::Point    size     = {};
+			sdl::Texture* texture  = nullptr;
+			bool          original = false;
+		};
+
+		std::string        filename;
+		sdl::Point         size = {}; // of the original, even once it is dropped
+		std::vector<Level> levels;    // largest first
+
+		// largest destination this source was drawn at since the last prescale, in pixels
+		mutable sdl::Point demand = {};
+		// set once a load was asked for, by a prefetch hint or by the first draw
+		mutable std::atomic<bool> requested = {false};
+
+		// smallest level that still covers the destination, or the largest one
+		auto pick(sdl::FPoint _size) const -> sdl::Texture*;
+	};
+
 	struct Texture
 	{
 		Rect destination;
 
-		sdl::Texture* ptr     = nullptr;
+		const Source* ptr     = nullptr;
 		sdl::Color    color   = {/*.r =*/ 255, /*.g =*/ 255, /*.b =*/ 255, /*.a =*/ 255};
-
-		void draw(sdl::Renderer* _renderer) const;
-		void draw(sdl::Renderer* _renderer, sdl::Rect _source) const;
 	};
 
+	class RenderList;
+
 	class TexturePool
 	{
 		sdl::Renderer* renderer = nullptr;
-		std::map<std::string, sdl::Texture*> dict;
+		// transparent, so lookups by string_view build no key
+		std::map<std::string, Source, std::less<>> dict;
+
+		struct Job
+		{
+			Source*    source   = nullptr;
+			sdl::Point size     = {};
+			bool       original = false;
+		};
+
+		struct Decoded
+		{
+			Source*       source   = nullptr;
+			sdl::Surface* surface  = nullptr;
+			bool          original = false;
+		};
+
+		util::Ring<Decoded, 64>  reloads;
+		util::Ring<Job, 256>     jobs;
+		util::Ring<Decoded, 256> results;
+
+		mutable util::Ring<const Source*, 64> hints;
+		// sprites drawn before they were loaded, from the render thread; room for every source of a first frame
+		util::Ring<const Source*, 256> misses;
+
+		// signaled whenever a hint, a miss or a job is queued, so the loader sleeps while there are none
+		mutable util::Wakeup pending;
+
+		std::thread       watcher;
+		std::thread       loader;
+		std::atomic<bool> watching = {false};
+		std::atomic<bool> loading  = {false};
+
+		// frames of demand gathered after a resize before variants are scheduled
+		static constexpr size_t settle = 8;
+
+		bool   drop      = false;
+		size_t countdown = 0;
+
+		void observe(std::string _directory);
+		void load();
+		void install(const Decoded& _decoded);
+		void schedule();
 
 	public:
-		TexturePool(sdl::Renderer* _renderer) : renderer(_renderer) {};
+		TexturePool(sdl::Renderer* _renderer);
 		~TexturePool();
 
+		TexturePool(const TexturePool&) = delete;
+		auto operator=(const TexturePool&) -> TexturePool& = delete;
+
+		// only registers the file, which has to exist; it is decoded when first drawn or when a prefetch hint arrives
 		void add(std::string_view _identifier, std::string_view _filename);
-		auto operator[](std::string_view _identifier) const -> sdl::Texture*;
+		auto operator[](std::string_view _identifier) const -> const Source*;
+
+		// decodes the source on the loader thread ahead of its first draw;
+		// hints may come from one thread other than the render thread
+		void prefetch(const Source* _source) const;
+		// queues every visible sprite of the list that is still missing on the loader thread, which never
+		// stalls the frame: the sprite is left out until refresh() installs it; it tells whether any was queued
+		bool prepare(const RenderList& _list);
+
+		// development mode: files rewritten in the directory are decoded on a background thread
+		// and swapped in by refresh(), which has to be called between frames on the render thread;
+		// it tells whether any texture was replaced
+		void watch(std::string_view _directory);
+		bool refresh();
+
+		// regenerates downscaled levels that match the sizes drawn once the layout settles;
+		// call it after a resize, also from the render thread
+		void prescale();
+		// with originals dropped only the variant stays resident until a larger size is drawn
+		void originals(bool _keep);
+
+		// SDL textures alive in the pool, originals and variants together
+		auto textures() const -> size_t;
 	};
 
-	struct Drawable : virtual Rect
+	struct Record
 	{
-		virtual void init(const graphics::TexturePool& _texture_pool) = 0;
-		virtual void draw(sdl::Renderer* _renderer) const = 0;
-		virtual void update() = 0;
+		enum class kind : Uint8
+		{
+			sprite, outline, fill, clip, unclip,
+		};
+
+		Uint32 key     = 0;
+		kind   type    = kind::sprite;
+		bool   visible = true;
+
+		const Source* ptr         = nullptr;
+		sdl::FRect    destination = {};
+		sdl::Color    color       = sdl::env::white;
+
+		size_t handle = 0;
 	};
 
-	class Frame
+	// Retained, contiguous list of draw records kept in z-order.
+	// Elements own handles to their records and rewrite them in place;
+	// the list is sorted again only after records were added or re-keyed.
+	class RenderList
 	{
-		sdl::Window*   window   = nullptr;
-		sdl::Renderer* renderer = nullptr;
-
 	public:
-		const sdl::Point size = {};
+		using handle_t = size_t;
+		using array_t  = std::vector<Record>;
+
+	private:
+		array_t             records;
+		std::vector<size_t> slots;
+
+		bool sorted  = true;
+		bool changed = true; // since the last clean(); writes of equal values do not count
 
 	public:
-		Frame(sdl::Window* _window, sdl::Renderer* _renderer, sdl::Point _size) :
-			window(_window), renderer(_renderer), size(_size) {}
+		RenderList() = default;
 
-	private:
-		template <typename _Func,typename... _Drawable, util::require<std::is_invocable_v<_Func, Drawable&>, util::derived<_Drawable, Drawable>...> = 0>
-		void apply(_Func _func, _Drawable&... _objects) const
+		static constexpr auto key(Uint32 _layer, Uint32 _order) -> Uint32
 		{
-			(void)std::initializer_list<int>{(_func(_objects), 0)...};
+			return (_layer << 16) | (_order & 0xFFFF);
 		}
 
-		template <typename _Func, typename... _Drawable, util::require<std::is_invocable_v<_Func, const Drawable&>, util::derived<_Drawable, Drawable>...> = 0>
-		void apply(_Func _func, const _Drawable&... _objects) const
+		auto insert(Uint32 _key, Record::kind _type) -> handle_t;
+		void rekey(handle_t _handle, Uint32 _key);
+
+		void assign(handle_t _handle, const Texture& _texture);
+		// clips leave the colour at its default, it means nothing to them
+		void assign(handle_t _handle, const Rect& _rect, sdl::Color _color = sdl::env::white);
+		void show(handle_t _handle, bool _visible = true);
+
+		// direct access always marks the list dirty
+		auto operator[](handle_t _handle) -> Record&;
+		auto operator[](handle_t _handle) const -> const Record&;
+
+		void sort();
+
+		// whether anything visible differs from what was last drawn
+		bool dirty() const;
+		void clean();
+
+		auto begin() const -> array_t::const_iterator;
+		auto end() const -> array_t::const_iterator;
+		auto size() const -> size_t;
+	};
+
+	// One SDL call of a frame, after culling and level selection:
+	// sprites carry the texture that was picked, clips the effective rectangle.
+	struct Command
+	{
+		enum class kind : Uint8
 		{
-			(void)std::initializer_list<int>{(_func(_objects), 0)...};
-		}
+			clear, sprite, outline, fill, clip, unclip,
+		};
+
+		kind          type        = kind::clear;
+		sdl::Color    color       = sdl::env::white;
+		sdl::FRect    destination = {};
+		sdl::Texture* texture     = nullptr;
+		const Source* ptr         = nullptr; // what the texture was picked from, for replays elsewhere
 
+		bool operator==(const Command& _other) const;
+		bool operator!=(const Command& _other) const;
+	};
+
+	// Commands of one frame in submission order
+	class DisplayList
+	{
 	public:
-		auto scaling() const -> sdl::FPoint;
+		using array_t = std::vector<Command>;
 
-		template <typename... _Drawable, util::require<util::derived<_Drawable, Drawable>...> = 0>
-		void scale(_Drawable&... _objects) const
-		{
-			apply([this](Drawable& _obj){ _obj.scaling = scaling(); }, _objects...);
-		}
-		template <typename... _Drawable, util::require<util::derived<_Drawable, Drawable>...> = 0>
-		void update(_Drawable&... _objects) const
+	private:
+		array_t commands;
+
+	public:
+		void push(const Command& _command);
+		void clear();
+
+		// commands equal to the ones at the same position of the other list
+		auto common(const DisplayList& _other) const -> size_t;
+
+		// submits to the renderer that owns the recorded textures
+		void replay(sdl::Renderer* _renderer) const;
+
+		// submits to another renderer; `_resolve(source, size)` picks that renderer's texture for a sprite
+		template <typename _Resolve, util::require<std::is_invocable_r_v<sdl::Texture*, _Resolve, const Source*, sdl::FPoint>> = 0>
+		void replay(sdl::Renderer* _renderer, _Resolve _resolve) const
 		{
-			apply([this](Drawable& _obj){ _obj.update(); }, _objects...);
+			for (Command command : commands)
+			{
+				if (command.type == Command::kind::sprite)
+					command.texture = command.ptr ? _resolve(command.ptr, {/*.x =*/ command.destination.w, /*.y =*/ command.destination.h}) : nullptr;
+				submit(_renderer, command);
+			}
 		}
-		template <typename... _Drawable, util::require<util::derived<_Drawable, Drawable>...> = 0>
-		void draw(const _Drawable&... _objects) const
+
+		// one line per command
+		void dump(std::FILE* _file) const;
+
+		auto begin() const -> array_t::const_iterator;
+		auto end() const -> array_t::const_iterator;
+		auto size() const -> size_t;
+
+		static void submit(sdl::Renderer* _renderer, const Command& _command);
+	};
+
+	// sees every finished back buffer right before it is presented
+	class Observer
+	{
+	public:
+		virtual ~Observer() = default;
+
+		virtual void presenting(sdl::Renderer* _renderer) = 0;
+	};
+
+	class Frame
+	{
+	public:
+		// what the last present did with the recorded commands
+		struct Submission
 		{
-			apply([this](const Drawable& _obj){ _obj.draw(renderer); }, _objects...);
-		}
+			size_t commands = 0;
+			size_t common   = 0; // unchanged since the frame before, at the same position
+			bool   skipped  = false;
+		};
 
-		void present() const;
+	private:
+		sdl::Window*   window   = nullptr;
+		sdl::Renderer* renderer = nullptr;
+
+		// with recording on, draw calls fill `recorded` and reach SDL only on present,
+		// and only when they differ from `submitted`, the list shown on screen now
+		bool recording = false;
+
+		DisplayList recorded;
+		DisplayList submitted;
+		Submission  last;
+		bool        stale = true;
+
+		Observer* observer = nullptr;
+
+		Uint64 issued = 0; // commands that reached SDL
 
-		void clear(sdl::Color _color) const;
-		void clear() const;
+		// nested clip rectangles of the current draw; emptied when it starts, its storage kept across frames
+		std::vector<sdl::FRect> clips;
+
+		// everything fully outside the innermost clip is culled before submission
+		bool culled(const sdl::FRect& _rect) const;
+		void clip(const sdl::FRect& _rect);
+		void unclip();
+		void confine();
+		void emit(const Command& _command);
+
+	public:
+		const sdl::Point size = {};
+
+	public:
+		Frame(sdl::Window* _window, sdl::Renderer* _renderer, sdl::Point _size) :
+			window(_window), renderer(_renderer), size(_size) {}
+
+	public:
+		// of a window `_window` large, as SDL reports it in resize events; pure arithmetic, safe on any thread
+		auto scaling(sdl::Point _window) const -> sdl::FPoint;
+
+		void draw(const RenderList& _list);
+
+		void present();
+
+		void clear(sdl::Color _color);
+		void clear();
+
+		void record(bool _enabled);
+		// the window lost its contents or textures were replaced, so the next present submits in any case
+		void invalidate();
+
+		void observe(Observer* _observer);
+
+		auto submission() const -> const Submission&;
+		// draw calls handed to SDL since the frame was created, clears and clip changes included
+		auto calls() const -> Uint64;
+		// the commands on screen, valid while recording
+		auto display() const -> const DisplayList&;
 	};
 
 	namespace type
 	{
 		using textures = std::map<std::string, std::string>;
-		using function = void (&)(const Frame&, const TexturePool&);
+		using function = std::function<void(Frame&, TexturePool&)>;
 	}
 
 	struct WindowData
@@ -131,12 +372,13 @@ namespace slots::graphics
 		} flags;
 	};
 
-	void draw(sdl::Renderer* _renderer, const Rect& _rect, sdl::Color _color = sdl::env::white);
-	void fill(sdl::Renderer* _renderer, const Rect& _rect, sdl::Color _color = sdl::env::white);
-
 	auto motion(const sdl::Event& _event) -> sdl::FPoint;
 
-	void context(const WindowData& _window_data, const type::textures& _textures, type::function _function);
+	// queues an event nothing handles, so a loop blocked in SDL_WaitEventTimeout picks up work
+	// that arrived without input; callable from any thread
+	void wake();
+
+	void context(const WindowData& _window_data, const type::textures& _textures, const type::function& _function);
 }
 
 #endif
\ No newline at end of file
@@ -6,13 +6,16 @@
 #include "bindings.h"
 #include "graphics.h"
 #include "elements.h"
+#include "audio.h"
+#include "journal.h"
+#include "crypto.h"
+
+#include <memory>
 
 namespace slots
 {
 	struct Interface
 	{
-		static constexpr size_t barrels_count = 5;
-
 		struct {
 			graphics::Rect barrel;
 			graphics::Rect start;
@@ -20,14 +23,25 @@ namespace slots
 			graphics::Rect reward;
 		} parameters;
 
-		Barrels<barrels_count> barrels;
+		// the cabinet variant, chosen before init()
+		std::unique_ptr<Reels> barrels;
 
 		Button start;
 		Button stop;
 
 		Reward reward;
 
+		graphics::RenderList scene;
+
+		audio::Mixer audio;
+
+		journal::Journal journal;
+
+		// one word of it per reel decides every spin
+		crypto::Stream entropy;
+
 		void init(const graphics::TexturePool& _texture_pool);
+		void update();
 		void place();
 
 		void layout(int _x, int _y);
@@ -0,0 +1,116 @@
+#pragma once
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "bindings.h"
+#include "utility.h"
+#include "crypto.h"
+
+#include <string_view>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <array>
+#include <cstdio>
+
+namespace slots::journal
+{
+	// One resolved spin. The timestamp is wall-clock milliseconds since the Unix epoch.
+	// The cabinet names the layout and paylines the stops were evaluated with, see cabinet::variants,
+	// and `strips` fingerprints the strips they index, see cabinet::fingerprint.
+	struct Entry
+	{
+		static constexpr size_t capacity = 8; // reels a record has room for
+		static constexpr size_t name     = 8; // bytes of the cabinet name, zero padded
+
+		Uint64 timestamp = 0;
+		Uint64 reward    = 0;
+
+		std::array<char, name> cabinet = {};
+		Uint64                 strips  = 0;
+
+		Uint8                        count = 0;
+		std::array<Uint16, capacity> stops = {};
+	};
+
+	// Append-only file of fixed-size little-endian records after a short header.
+	// Every record ends with SHA-256(previous hash || record body), the first one chains
+	// from the hash of the header, so editing, dropping or reordering records breaks the chain.
+	//
+	// The game thread only pushes entries into a ring; a writer thread hashes them,
+	// writes whatever has accumulated and syncs the file once per batch.
+	// A record that cannot be queued, written or synced fails the journal for good: the chain
+	// stays at the last record on disk, nothing more is written and play has to stop.
+	class Journal
+	{
+	public:
+		using digest_t = crypto::Sha256::digest_t;
+
+		static constexpr char   magic[8]  = {'S', 'L', 'O', 'T', 'S', 'J', '3', '\0'};
+		static constexpr size_t body_size = 8 + 8 + 8 + Entry::name + 8 + 1 + Entry::capacity * 2;
+		static constexpr size_t size      = body_size + crypto::Sha256::digest_size;
+
+		// how long the writer lets entries accumulate before committing them
+		static constexpr auto window = std::chrono::milliseconds(10);
+
+		using record_t = std::array<Uint8, size>;
+		using body_t   = std::array<Uint8, body_size>;
+
+		struct Audit
+		{
+			Uint64   records = 0;     // valid records from the start of the file
+			bool     intact  = false; // header and every complete record check out
+			bool     torn    = false; // the file ends inside a record, e.g. after a crash
+			digest_t head    = {};    // hash of the last valid record
+		};
+
+	private:
+		std::FILE*  file = nullptr;
+		std::string path;
+
+		util::Ring<Entry, 1024> entries;
+
+		std::thread       writer;
+		std::atomic<bool> running = {false};
+		std::atomic<bool> broken  = {false};
+		bool              stuck   = false; // the writer failed to write or sync, and writes nothing more
+
+		// of the last record written and synced
+		Uint64   sequence = 0;
+		digest_t chain    = {};
+
+		std::vector<record_t> batch;
+
+		void run();
+		void commit();
+
+	public:
+		Journal() = default;
+		~Journal();
+
+		Journal(const Journal&) = delete;
+		auto operator=(const Journal&) -> Journal& = delete;
+
+		// reopens an existing journal after checking its chain and cutting off a torn last record;
+		// a file cut short inside its header, by a crash right after it was created, is started over
+		bool open(std::string_view _path);
+		void close();
+
+		// never blocks; false if the record could not be queued, which fails the journal.
+		// With no journal open every entry is accepted and dropped.
+		bool append(const Entry& _entry);
+		// a record was lost, so no spin may be played any more
+		bool failed() const;
+
+		static auto encode(Uint64 _sequence, const Entry& _entry) -> body_t;
+		static auto link(const digest_t& _previous, const body_t& _body) -> digest_t;
+		static auto origin() -> digest_t;
+
+		static auto verify(std::string_view _path) -> Audit;
+	};
+}
+
+#endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #define LIST_H
 
 #include <initializer_list>
+#include <cstddef>
 
 namespace slots::env
 {
@@ -18,6 +19,122 @@ namespace slots::env
 		"cat-present",
 	};
 
+	// virtual stops on every reel
+	static constexpr size_t reel_length = 256;
+
+	// virtual stop weights of the cats above, same order
+	static constexpr auto weights = {
+		30u,
+		25u,
+		20u,
+		15u,
+		12u,
+		8u,
+		5u,
+		3u,
+	};
+
+	// stops every cat takes on each strip, same order; together they fill the strip
+	static constexpr auto occurrences = {
+		32u,
+		32u,
+		32u,
+		32u,
+		32u,
+		32u,
+		32u,
+		32u,
+	};
+
+	// the strips are shuffled from this seed, the cabinet and the reel, so every build and every run spins the same ones
+	static constexpr unsigned long long strip_seed = 0x51075C47F00D5EEDull;
+
+	// paylines of each cabinet: the row of every reel, counted from the top
+
+	static constexpr unsigned char paylines_3x3[][3] = {
+		{1, 1, 1},
+		{0, 0, 0},
+		{2, 2, 2},
+		{0, 1, 2},
+		{2, 1, 0},
+	};
+
+	static constexpr unsigned char paylines_5x3[][5] = {
+		{1, 1, 1, 1, 1},
+		{0, 0, 0, 0, 0},
+		{2, 2, 2, 2, 2},
+		{0, 1, 2, 1, 0},
+		{2, 1, 0, 1, 2},
+		{0, 0, 1, 2, 2},
+		{2, 2, 1, 0, 0},
+		{1, 0, 0, 0, 1},
+		{1, 2, 2, 2, 1},
+		{1, 0, 1, 2, 1},
+		{1, 2, 1, 0, 1},
+		{0, 1, 0, 1, 0},
+		{2, 1, 2, 1, 2},
+		{1, 1, 0, 1, 1},
+		{1, 1, 2, 1, 1},
+		{0, 1, 1, 1, 0},
+		{2, 1, 1, 1, 2},
+		{0, 2, 0, 2, 0},
+		{2, 0, 2, 0, 2},
+		{0, 2, 2, 2, 0},
+	};
+
+	static constexpr unsigned char paylines_5x4[][5] = {
+		{1, 1, 1, 1, 1},
+		{2, 2, 2, 2, 2},
+		{0, 0, 0, 0, 0},
+		{3, 3, 3, 3, 3},
+		{0, 1, 2, 1, 0},
+		{3, 2, 1, 2, 3},
+		{1, 2, 3, 2, 1},
+		{2, 1, 0, 1, 2},
+		{0, 1, 2, 3, 3},
+		{3, 2, 1, 0, 0},
+		{1, 0, 0, 0, 1},
+		{2, 3, 3, 3, 2},
+		{1, 2, 2, 2, 1},
+		{2, 1, 1, 1, 2},
+		{0, 1, 1, 1, 0},
+		{3, 2, 2, 2, 3},
+		{1, 1, 0, 1, 1},
+		{2, 2, 3, 2, 2},
+		{0, 1, 0, 1, 0},
+		{3, 2, 3, 2, 3},
+	};
+
+	static constexpr unsigned char paylines_6x5[][6] = {
+		{2, 2, 2, 2, 2, 2},
+		{1, 1, 1, 1, 1, 1},
+		{3, 3, 3, 3, 3, 3},
+		{0, 0, 0, 0, 0, 0},
+		{4, 4, 4, 4, 4, 4},
+		{0, 1, 2, 2, 1, 0},
+		{4, 3, 2, 2, 3, 4},
+		{1, 2, 3, 3, 2, 1},
+		{3, 2, 1, 1, 2, 3},
+		{0, 1, 2, 3, 4, 4},
+		{4, 3, 2, 1, 0, 0},
+		{2, 1, 0, 0, 1, 2},
+		{2, 3, 4, 4, 3, 2},
+		{1, 0, 1, 0, 1, 0},
+		{3, 4, 3, 4, 3, 4},
+		{2, 1, 2, 1, 2, 1},
+		{2, 3, 2, 3, 2, 3},
+		{0, 0, 1, 1, 2, 2},
+		{4, 4, 3, 3, 2, 2},
+		{1, 1, 2, 2, 3, 3},
+	};
+
+	// the rarest cat also pays as a scatter, wherever it lands in the window
+	namespace scatter
+	{
+		static constexpr size_t symbol  = 7;
+		static constexpr size_t minimum = 3;
+	}
+
 	static constexpr auto symbols = {
 		"zero",
 		"one",
@@ -36,6 +153,21 @@ namespace slots::env
 		"stop",
 		"start",
 	};
+
+	static constexpr auto sounds = {
+		"spin",
+		"click",
+		"win",
+	};
+
+	// indices into sounds
+	namespace sound
+	{
+		enum : size_t
+		{
+			spin, click, win,
+		};
+	}
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "bindings.h"
+#include "states.h"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <array>
+
+namespace slots::metrics
+{
+	// Every update is a single relaxed atomic add, so recording from the frame loop
+	// never locks and never allocates; only the exporter thread reads the values.
+	class Counter
+	{
+		std::atomic<Uint64> value = {0};
+
+	public:
+		void add(Uint64 _amount = 1)
+		{
+			value.fetch_add(_amount, std::memory_order_relaxed);
+		}
+
+		auto load() const -> Uint64
+		{
+			return value.load(std::memory_order_relaxed);
+		}
+	};
+
+	class Histogram
+	{
+	public:
+		static constexpr size_t bounds_count = 12;
+
+		using bounds_t = std::array<Uint64, bounds_count>;  // upper bounds, ascending
+		using counts_t = std::array<Counter, bounds_count + 1>; // the last one is +Inf
+
+	private:
+		const bounds_t bounds;
+
+		counts_t counts;
+		Counter  sum;
+
+	public:
+		Histogram(const bounds_t& _bounds) : bounds(_bounds) {}
+
+		void observe(Uint64 _value);
+
+		auto bound(size_t _index) const -> Uint64;
+		auto count(size_t _index) const -> Uint64;
+		auto total() const -> Uint64;
+		auto accumulated() const -> Uint64;
+
+		// interpolated inside the bucket that holds the quantile
+		auto quantile(double _quantile) const -> double;
+	};
+
+	struct Registry
+	{
+		using clock_t = std::chrono::steady_clock;
+		using unit_t  = std::chrono::nanoseconds;
+
+		static constexpr size_t states_count = static_cast<env::state_t>(env::state::last);
+
+		Counter spins;
+		Counter paid;
+
+		// what halted play for good: the outcome stream failed its health tests, or the journal lost a record
+		enum halt : size_t
+		{
+			stream, journal,
+			halts_count
+		};
+
+		std::array<std::atomic<bool>, halts_count> halted = {};
+
+		// presses of start ignored while play is halted
+		Counter refused;
+
+		std::array<Counter, states_count> entered;
+		std::array<Counter, states_count> elapsed; // nanoseconds
+
+		Counter frames;
+		Counter dropped;
+
+		Histogram frame_time = Histogram::bounds_t{
+			 2'000'000,  4'000'000,  8'000'000, 12'000'000,
+			16'000'000, 17'000'000, 20'000'000, 25'000'000,
+			33'000'000, 50'000'000, 100'000'000, 250'000'000,
+		};
+
+		// recorded display lists: commands drawn, how many repeat the frame before, and presents skipped
+		Counter commands;
+		Counter unchanged;
+		Counter skipped;
+
+		void state(env::state _state, unit_t _elapsed);
+		void frame(unit_t _elapsed, unit_t _budget);
+		void display(size_t _commands, size_t _unchanged, bool _skipped);
+	};
+
+	auto registry() -> Registry&;
+
+	// Prometheus text exposition format
+	auto format(const Registry& _registry) -> std::string;
+
+	// Periodically writes the registry next to the target and renames it over,
+	// so a scraper reading the file never sees a partial write.
+	class Exporter
+	{
+		std::string path;
+		std::chrono::milliseconds period;
+
+		std::thread       writer;
+		std::atomic<bool> running = {false};
+
+		void run();
+		bool write() const;
+
+	public:
+		Exporter() = default;
+		~Exporter();
+
+		Exporter(const Exporter&) = delete;
+		auto operator=(const Exporter&) -> Exporter& = delete;
+
+		void start(std::string_view _path, std::chrono::milliseconds _period = std::chrono::seconds(5));
+		void stop();
+	};
+}
+
+#endif
\ No newline at end of file
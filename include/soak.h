@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef SOAK_H
+#define SOAK_H
+
+#include "bindings.h"
+#include "graphics.h"
+#include "states.h"
+#include "game.h"
+
+#include <chrono>
+#include <vector>
+#include <array>
+
+namespace slots::soak
+{
+	// resident set size of the process in bytes, zero where the platform does not tell
+	auto resident() -> size_t;
+
+	// Drives the game loop with synthetic presses for a number of spins and watches it meanwhile:
+	// resident memory, live textures, frame times and the reel invariants, reported every `period`.
+	// Presses are pushed into the SDL event queue, so they reach the states the way real ones do.
+	// Once the spins are done it pushes SDL_QUIT. Its hooks share every counter, so it plays
+	// through the serial loop only.
+	class Soak : public Script
+	{
+	public:
+		using clock_t = std::chrono::steady_clock;
+
+		static constexpr auto   period        = std::chrono::seconds(10);
+		static constexpr size_t samples_count = 1 << 14; // newest frame times behind the percentiles of a report
+
+		static constexpr size_t states_count = static_cast<env::state_t>(env::state::last);
+
+	private:
+		size_t target = 0; // spins; zero keeps the soak off
+
+		size_t spins   = 0;
+		Uint64 frames  = 0;
+		size_t drifts  = 0;
+		size_t waiting = 0; // frames the stop button has been active for
+
+		env::state                       previous = env::state::wait; // as presented last
+		env::state                       checked  = env::state::wait; // as drive() saw it last
+		std::array<Uint64, states_count> entered  = {};
+
+		std::vector<Uint32> samples; // nanoseconds between presents, a ring
+		std::vector<Uint32> sorted;
+		Uint64              sampled = 0;
+		Uint64              slowest = 0;
+
+		clock_t::time_point started  = {};
+		clock_t::time_point reported = {};
+		clock_t::time_point last     = {};
+
+		// at the first report, after loading and prescaling settled
+		size_t resident_baseline = 0;
+		size_t textures_baseline = 0;
+
+		void check(const Game& _game, bool _landed);
+		void report(const graphics::TexturePool& _texture_pool);
+
+	public:
+		Soak() = default;
+
+		void start(size_t _spins);
+		bool active() const;
+		// whether no reel drifted so far
+		bool intact() const;
+
+		void drive(const Game& _game) override;
+		void presented(env::state _state, const graphics::TexturePool& _texture_pool) override;
+	};
+}
+
+#endif
\ No newline at end of file
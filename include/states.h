@@ -39,7 +39,7 @@ namespace slots
 
 		struct Scale {
 			Interface& interface;
-			const graphics::Frame& frame;
+			sdl::FPoint scale;
 		};
 
 		struct Update {
@@ -49,13 +49,18 @@ namespace slots
 
 		struct Draw {
 			const Interface& interface;
-			const graphics::Frame& frame;
+			graphics::Frame& frame;
 		};
 
 		struct End {
 			const Interface& interface;
 		};
 
+		struct Prefetch {
+			const Interface& interface;
+			const graphics::TexturePool& texture_pool;
+		};
+
 		size_t updated = 0;
 		const env::state type;
 		State(env::state _type) : type(_type) {}
@@ -64,8 +69,11 @@ namespace slots
 		virtual void handle(Handle _data) = 0;
 		virtual void scale(Scale _data);
 		virtual void update(Update _data) = 0;
-		virtual void draw(Draw _data) = 0;
+		virtual void draw(Draw _data);
 		virtual bool end(End _data) = 0;
+		// hints the textures this state draws first, while the previous state is still running;
+		// by default every sprite the scene already refers to
+		virtual void prefetch(Prefetch _data);
 	};
 
 	struct Wait : State
@@ -75,7 +83,6 @@ namespace slots
 		void begin(Begin _data) override;
 		void handle(Handle _data) override;
 		void update(Update _data) override;
-		void draw(Draw _data) override;
 		bool end(End _data) override;
 	};
 
@@ -86,7 +93,6 @@ namespace slots
 		void begin(Begin _data) override;
 		void handle(Handle _data) override;
 		void update(Update _data) override;
-		void draw(Draw _data) override;
 		bool end(End _data) override;
 	};
 
@@ -99,7 +105,6 @@ namespace slots
 		void begin(Begin _data) override;
 		void handle(Handle _data) override;
 		void update(Update _data) override;
-		void draw(Draw _data) override;
 		bool end(End _data) override;
 	};
 
@@ -110,7 +115,6 @@ namespace slots
 		void begin(Begin _data) override;
 		void handle(Handle _data) override;
 		void update(Update _data) override;
-		void draw(Draw _data) override;
 		bool end(End _data) override;
 	};
 
@@ -121,8 +125,8 @@ namespace slots
 		void begin(Begin _data) override;
 		void handle(Handle _data) override;
 		void update(Update _data) override;
-		void draw(Draw _data) override;
 		bool end(End _data) override;
+		void prefetch(Prefetch _data) override;
 	};
 
 	class StateMachine
@@ -137,6 +141,8 @@ namespace slots
 		StateMachine();
 
 		auto current() const -> State*;
+		auto upcoming() const -> State*;
+		auto type() const -> env::state;
 		void next();
 	};
 }
@@ -7,7 +7,13 @@
 
 #include <initializer_list>
 #include <type_traits>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <random>
+#include <vector>
+#include <array>
 
 namespace util
 {
@@ -41,6 +47,160 @@ namespace util
 		return _distribution(engine);
 	}
 
+	// Walker/Vose alias table over integer weights.
+	// Construction is O(n), every draw is O(1): one column pick and one threshold compare.
+	class Alias
+	{
+		std::vector<Uint32> threshold;
+		std::vector<Uint32> alias;
+		Uint32 total = 0;
+
+	public:
+		Alias() = default;
+
+		void assign(const Uint32* _weights, size_t _count);
+
+		template <typename _Range, require<range<_Range>> = 0>
+		void assign(const _Range& _weights)
+		{
+			auto weights = std::vector<Uint32>(std::begin(_weights), std::end(_weights));
+			assign(weights.data(), weights.size());
+		}
+
+		auto size() const -> size_t;
+
+		// high 32 bits pick the column, low 32 bits are compared against its threshold
+		auto operator()(Uint64 _entropy) const -> size_t;
+	};
+
+	// Single-producer single-consumer lock-free queue.
+	// Neither side allocates or blocks: push fails when full, pop fails when empty.
+	template <typename _Type, size_t _capacity>
+	class Ring
+	{
+		static_assert(_capacity && (_capacity & (_capacity - 1)) == 0, "ring capacity must be a power of two");
+
+		static constexpr size_t mask = _capacity - 1;
+
+		std::array<_Type, _capacity> buffer = {};
+
+		alignas(64) std::atomic<size_t> head = {0};
+		alignas(64) std::atomic<size_t> tail = {0};
+
+	public:
+		Ring() = default;
+
+		bool push(const _Type& _value)
+		{
+			size_t back = tail.load(std::memory_order_relaxed);
+			if (back - head.load(std::memory_order_acquire) == _capacity)
+				return false;
+			buffer[back & mask] = _value;
+			tail.store(back + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(_Type& _value)
+		{
+			size_t front = head.load(std::memory_order_relaxed);
+			if (front == tail.load(std::memory_order_acquire))
+				return false;
+			_value = buffer[front & mask];
+			head.store(front + 1, std::memory_order_release);
+			return true;
+		}
+
+		auto size() const -> size_t
+		{
+			return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+		}
+
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		static constexpr auto capacity() -> size_t
+		{
+			return _capacity;
+		}
+	};
+
+	// Lock-free triple buffer: one writer publishes whole values, one reader always gets the latest.
+	// Neither side waits for the other; values the reader was too slow for are skipped.
+	template <typename _Type>
+	class TripleBuffer
+	{
+		static constexpr Uint8 index = 0x3;
+		static constexpr Uint8 fresh = 0x4;
+
+		std::array<_Type, 3> slots = {};
+
+		std::atomic<Uint8> middle = {1};
+
+		Uint8 back  = 0;
+		Uint8 front = 2;
+
+	public:
+		TripleBuffer() = default;
+
+		// before either side runs; every slot starts as a copy of `_value`, with its storage
+		void fill(const _Type& _value)
+		{
+			slots.fill(_value);
+		}
+
+		// writer side
+		auto write() -> _Type&
+		{
+			return slots[back];
+		}
+		void publish()
+		{
+			back = middle.exchange(back | fresh, std::memory_order_acq_rel) & index;
+		}
+
+		// reader side; returns whether a newer value was picked up
+		bool acquire()
+		{
+			if (!(middle.load(std::memory_order_relaxed) & fresh))
+				return false;
+			front = middle.exchange(front, std::memory_order_acq_rel) & index;
+			return true;
+		}
+		auto read() const -> const _Type&
+		{
+			return slots[front];
+		}
+	};
+
+	// Lets a worker sleep until another thread has something for it or the timeout passes.
+	// A notification that arrives while nobody waits is kept for the next wait, so none is lost.
+	class Wakeup
+	{
+		std::mutex              mutex;
+		std::condition_variable condition;
+		bool                    signaled = false;
+
+	public:
+		void notify()
+		{
+			{
+				std::lock_guard lock(mutex);
+				signaled = true;
+			}
+			condition.notify_one();
+		}
+
+		template <typename _Rep, typename _Period>
+		void wait(std::chrono::duration<_Rep, _Period> _timeout)
+		{
+			std::unique_lock lock(mutex);
+			condition.wait_for(lock, _timeout, [this]() { return signaled; });
+			signaled = false;
+		}
+	};
+
 	template <typename _Type, require<std::is_arithmetic_v<_Type>> = 0>
 	auto operator+(sdl::FPoint _point, _Type _val) -> sdl::FPoint
 	{
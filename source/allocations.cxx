@@ -0,0 +1,341 @@
+#include "bindings.h"
+#include "allocations.h"
+
+#ifdef SLOTS_TRACK_ALLOCATIONS
+
+#include <SDL_log.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <array>
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#include <unistd.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace slots::allocations
+{
+	namespace
+	{
+		constexpr size_t phases_count = static_cast<size_t>(phase::last);
+
+		constexpr const char* names[phases_count] = {
+			"other", "events", "update", "publish", "prepare", "draw", "present",
+		};
+
+		// frames of the stack kept per call site, innermost first
+		constexpr size_t depth = 8;
+		constexpr size_t sites_capacity = 32;
+
+		struct Site
+		{
+			std::array<void*, depth> frames = {};
+			size_t                   size   = 0; // frames captured
+			phase                    where  = phase::other;
+			Uint64                   count  = 0;
+			Uint64                   bytes  = 0;
+		};
+
+		// Everything is per thread and trivially constructible, so touching it from
+		// inside operator new never allocates and never needs a lock.
+		struct Tracker
+		{
+			const char* thread  = nullptr;
+			bool        enabled = false;
+			bool        inside  = false; // guards against counting the tracker's own work
+			bool        steady  = false;
+			phase       current = phase::other;
+
+			Uint64 frame = 0;
+			size_t quiet = 0; // settled frames in a row; allocations during the warmup are first-use growth
+
+			std::array<Uint64, phases_count> counts = {};
+			std::array<Uint64, phases_count> bytes  = {};
+
+			std::array<Site, sites_capacity> sites = {};
+			size_t                           used  = 0;
+			Uint64                           lost  = 0; // allocations from sites that did not fit
+		};
+
+		thread_local Tracker tracker;
+
+		auto capture(std::array<void*, depth>& _frames) -> size_t
+		{
+#if defined(__GLIBC__)
+			return (size_t)backtrace(_frames.data(), (int)_frames.size());
+#elif defined(_MSC_VER)
+			_frames[0] = _ReturnAddress();
+			return 1;
+#else
+			_frames[0] = __builtin_return_address(0);
+			return 1;
+#endif
+		}
+
+		void record(size_t _size)
+		{
+			Tracker& self = tracker;
+			if (!self.enabled || self.inside)
+				return;
+			self.inside = true;
+
+			size_t index = static_cast<size_t>(self.current);
+			self.counts[index]++;
+			self.bytes[index] += _size;
+
+			if (self.steady)
+			{
+				Site site;
+				site.size  = capture(site.frames);
+				site.where = self.current;
+
+				auto same = [&](const Site& _other) { return _other.size == site.size && _other.where == site.where && _other.frames == site.frames; };
+				auto found = std::find_if(self.sites.begin(), self.sites.begin() + self.used, same);
+				if (found == self.sites.begin() + self.used)
+				{
+					if (self.used < sites_capacity)
+						self.sites[self.used++] = site;
+					else
+						found = self.sites.end();
+				}
+				if (found != self.sites.end())
+				{
+					found->count++;
+					found->bytes += _size;
+				}
+				else
+					self.lost++;
+			}
+
+			self.inside = false;
+		}
+
+		void report(const Tracker& _tracker)
+		{
+			Uint64 total = 0;
+			for (Uint64 count : _tracker.counts)
+				total += count;
+
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "steady frame %llu of the %s thread allocated %llu times", (unsigned long long)_tracker.frame, _tracker.thread, (unsigned long long)total);
+			for (size_t i = 0; i < phases_count; i++)
+				if (_tracker.counts[i])
+					SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "  %-8s %llu allocations, %llu bytes", names[i], (unsigned long long)_tracker.counts[i], (unsigned long long)_tracker.bytes[i]);
+
+			for (size_t i = 0; i < _tracker.used; i++)
+			{
+				const Site& site = _tracker.sites[i];
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "call site %zu, during %s: %llu allocations, %llu bytes", i, names[static_cast<size_t>(site.where)], (unsigned long long)site.count, (unsigned long long)site.bytes);
+#if defined(__GLIBC__)
+				// straight to the descriptor: symbolizing into strings would allocate again
+				backtrace_symbols_fd(site.frames.data(), (int)site.size, STDERR_FILENO);
+#else
+				for (size_t frame = 0; frame < site.size; frame++)
+					SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "    %p", site.frames[frame]);
+#endif
+			}
+			if (_tracker.lost)
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%llu more allocations from sites beyond the first %zu", (unsigned long long)_tracker.lost, sites_capacity);
+		}
+	}
+
+	void track(const char* _thread)
+	{
+#if defined(__GLIBC__)
+		// the first backtrace loads the unwinder, which must not happen inside a counted allocation
+		std::array<void*, depth> frames;
+		backtrace(frames.data(), (int)frames.size());
+#endif
+		// a thread that plays several loops, as the benchmark does, starts over with each of them
+		Tracker& self = tracker;
+		self.thread  = _thread;
+		self.enabled = true;
+		self.steady  = false;
+		self.quiet   = 0;
+		self.counts  = {};
+		self.bytes   = {};
+		self.used    = 0;
+		self.lost    = 0;
+	}
+
+	void enter(phase _phase)
+	{
+		tracker.current = _phase;
+	}
+
+	auto current() -> phase
+	{
+		return tracker.current;
+	}
+
+	void frame(bool _settled)
+	{
+		Tracker& self = tracker;
+		if (!self.enabled)
+			return;
+
+		Uint64 total = 0;
+		for (Uint64 count : self.counts)
+			total += count;
+
+		// one-off work such as a texture load may allocate, it only starts the warmup over
+		if (self.steady && total && _settled)
+		{
+			self.inside = true;
+			report(self);
+			std::abort();
+		}
+
+		self.frame++;
+		self.quiet  = _settled ? self.quiet + 1 : 0;
+		self.steady = self.quiet >= warmup;
+
+		self.counts = {};
+		self.bytes  = {};
+		self.used   = 0;
+		self.lost   = 0;
+	}
+}
+
+namespace
+{
+	auto allocate(size_t _size) -> void*
+	{
+		slots::allocations::record(_size);
+		return std::malloc(_size ? _size : 1);
+	}
+
+	auto allocate(size_t _size, std::align_val_t _alignment) -> void*
+	{
+		slots::allocations::record(_size);
+		size_t alignment = std::max(static_cast<size_t>(_alignment), sizeof(void*));
+#ifdef _MSC_VER
+		return _aligned_malloc(_size ? _size : 1, alignment);
+#else
+		// aligned_alloc wants the size to be a multiple of the alignment
+		return std::aligned_alloc(alignment, (std::max<size_t>(_size, 1) + alignment - 1) / alignment * alignment);
+#endif
+	}
+
+	void release(void* _pointer, std::align_val_t)
+	{
+#ifdef _MSC_VER
+		_aligned_free(_pointer);
+#else
+		std::free(_pointer);
+#endif
+	}
+}
+
+auto operator new(size_t _size) -> void*
+{
+	if (void* pointer = allocate(_size))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+auto operator new[](size_t _size) -> void*
+{
+	if (void* pointer = allocate(_size))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+auto operator new(size_t _size, const std::nothrow_t&) noexcept -> void*
+{
+	return allocate(_size);
+}
+
+auto operator new[](size_t _size, const std::nothrow_t&) noexcept -> void*
+{
+	return allocate(_size);
+}
+
+auto operator new(size_t _size, std::align_val_t _alignment) -> void*
+{
+	if (void* pointer = allocate(_size, _alignment))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+auto operator new[](size_t _size, std::align_val_t _alignment) -> void*
+{
+	if (void* pointer = allocate(_size, _alignment))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+auto operator new(size_t _size, std::align_val_t _alignment, const std::nothrow_t&) noexcept -> void*
+{
+	return allocate(_size, _alignment);
+}
+
+auto operator new[](size_t _size, std::align_val_t _alignment, const std::nothrow_t&) noexcept -> void*
+{
+	return allocate(_size, _alignment);
+}
+
+void operator delete(void* _pointer) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete(void* _pointer, size_t) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, size_t) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete(void* _pointer, const std::nothrow_t&) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, const std::nothrow_t&) noexcept
+{
+	std::free(_pointer);
+}
+
+void operator delete(void* _pointer, std::align_val_t _alignment) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+void operator delete[](void* _pointer, std::align_val_t _alignment) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+void operator delete(void* _pointer, size_t, std::align_val_t _alignment) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+void operator delete[](void* _pointer, size_t, std::align_val_t _alignment) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+void operator delete(void* _pointer, std::align_val_t _alignment, const std::nothrow_t&) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+void operator delete[](void* _pointer, std::align_val_t _alignment, const std::nothrow_t&) noexcept
+{
+	release(_pointer, _alignment);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "bindings.h"
+#include "utility.h"
+#include "audio.h"
+
+#include <SDL_log.h>
+#include <algorithm>
+#include <cstring>
+
+namespace slots::audio
+{
+	Mixer::~Mixer()
+	{
+		if (device)
+			SDL_CloseAudioDevice(device);
+		if (initialized)
+			SDL_QuitSubSystem(sdl::init::AUDIO);
+	}
+
+	bool Mixer::open()
+	{
+		// a cabinet without a sound card still has to run, so failures only silence the mixer
+		if (!SDL_WasInit(sdl::init::AUDIO))
+		{
+			if (SDL_InitSubSystem(sdl::init::AUDIO))
+			{
+				SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%s", SDL_GetError());
+				return false;
+			}
+			initialized = true;
+		}
+
+		sdl::AudioSpec desired = {};
+		desired.freq     = frequency;
+		desired.format   = AUDIO_F32SYS;
+		desired.channels = channels;
+		desired.samples  = samples;
+		desired.callback = callback;
+		desired.userdata = this;
+
+		device = SDL_OpenAudioDevice(nullptr, false, &desired, &spec, 0);
+		if (!device)
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%s", SDL_GetError());
+			return false;
+		}
+		return true;
+	}
+
+	void Mixer::add(std::string_view _filename)
+	{
+		// the callback reads the samples without a lock, so the vector must not move once it runs
+		if (started)
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%.*s: sounds cannot be added after the mixer started", (int)_filename.size(), _filename.data());
+			return;
+		}
+
+		// keeps sound ids aligned with the registration order even if a file is missing
+		auto& pcm = sounds.emplace_back();
+
+		if (!device)
+			return;
+
+		sdl::AudioSpec source = {};
+		Uint8*         buffer = nullptr;
+		Uint32         length = 0;
+
+		if (!SDL_LoadWAV(_filename.data(), &source, &buffer, &length))
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%s", SDL_GetError());
+			return;
+		}
+
+		SDL_AudioCVT cvt;
+		if (SDL_BuildAudioCVT(&cvt, source.format, source.channels, source.freq, spec.format, spec.channels, spec.freq) < 0)
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%s", SDL_GetError());
+			SDL_FreeWAV(buffer);
+			return;
+		}
+
+		auto converted = std::vector<Uint8>((size_t)length * std::max(cvt.len_mult, 1));
+		std::memcpy(converted.data(), buffer, length);
+		SDL_FreeWAV(buffer);
+
+		cvt.buf = converted.data();
+		cvt.len = (int)length;
+		if (SDL_ConvertAudio(&cvt))
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_AUDIO, "%s", SDL_GetError());
+			return;
+		}
+
+		pcm.resize(cvt.len_cvt / sizeof(float));
+		std::memcpy(pcm.data(), converted.data(), pcm.size() * sizeof(float));
+	}
+
+	void Mixer::start()
+	{
+		if (!device)
+			return;
+		started = true;
+		SDL_PauseAudioDevice(device, false);
+	}
+
+	bool Mixer::play(sound_t _sound, bool _loop)
+	{
+		if (!started)
+			return false;
+		return commands.push({/*.type =*/ Command::kind::play, /*.sound =*/ _sound, /*.loop =*/ _loop});
+	}
+
+	bool Mixer::stop(sound_t _sound)
+	{
+		if (!started)
+			return false;
+		return commands.push({/*.type =*/ Command::kind::stop, /*.sound =*/ _sound});
+	}
+
+	// -----------------------------------------
+
+	void Mixer::callback(void* _userdata, Uint8* _stream, int _length)
+	{
+		auto* mixer = static_cast<Mixer*>(_userdata);
+
+		for (Command command; mixer->commands.pop(command);)
+			mixer->apply(command);
+
+		mixer->mix(reinterpret_cast<float*>(_stream), _length / sizeof(float));
+	}
+
+	void Mixer::apply(const Command& _command)
+	{
+		if (_command.sound >= sounds.size())
+			return;
+
+		switch (_command.type)
+		{
+		case Command::kind::play:
+			for (auto& voice : voices)
+				if (!voice.pcm)
+				{
+					voice = {/*.pcm =*/ &sounds[_command.sound], /*.sound =*/ _command.sound, /*.position =*/ 0, /*.loop =*/ _command.loop};
+					return;
+				}
+			break;
+		case Command::kind::stop:
+			for (auto& voice : voices)
+				if (voice.pcm && voice.sound == _command.sound)
+					voice.pcm = nullptr;
+			break;
+		}
+	}
+
+	void Mixer::mix(float* _stream, size_t _count)
+	{
+		std::fill(_stream, _stream + _count, 0.F);
+
+		for (auto& voice : voices)
+		{
+			if (!voice.pcm)
+				continue;
+
+			const std::vector<float>& pcm = *voice.pcm;
+			if (pcm.empty())
+			{
+				voice.pcm = nullptr;
+				continue;
+			}
+
+			for (size_t i = 0; i < _count; i++)
+			{
+				if (voice.position == pcm.size())
+				{
+					if (!voice.loop)
+					{
+						voice.pcm = nullptr;
+						break;
+					}
+					voice.position = 0;
+				}
+				_stream[i] += pcm[voice.position++];
+			}
+		}
+
+		for (size_t i = 0; i < _count; i++)
+			_stream[i] = std::clamp(_stream[i], -1.F, 1.F);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#include "bindings.h"
+#include "graphics.h"
+#include "interface.h"
+#include "game.h"
+#include "bench.h"
+
+#include <SDL_log.h>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace slots::bench
+{
+	namespace
+	{
+		constexpr const char* names[scenarios_count] = {
+			"idle", "spin", "reward",
+		};
+
+		// frame time the cabinets have to hold
+		constexpr double budget = 1000. / 60.;
+	}
+
+	auto name(scenario _scenario) -> const char*
+	{
+		return names[static_cast<size_t>(_scenario)];
+	}
+
+	auto cpu() -> double
+	{
+#if defined(_WIN32)
+		FILETIME creation, exit, kernel, user;
+		if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+			return 0;
+		// both in 100 ns ticks
+		auto ticks = [](const FILETIME& _time) { return ((Uint64)_time.dwHighDateTime << 32) | _time.dwLowDateTime; };
+		return (double)(ticks(kernel) + ticks(user)) / 1e7;
+#else
+		timespec time = {};
+		if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time))
+			return 0;
+		return (double)time.tv_sec + (double)time.tv_nsec / 1e9;
+#endif
+	}
+
+	Run::Run(const Case& _case, clock_t::duration _duration) :
+		test(_case), duration(_duration) {}
+
+	void Run::start(Game& _game, const graphics::Frame& _frame)
+	{
+		frame = &_frame;
+		samples.assign(samples_count, 0.F);
+
+		// every digit the reward can hold; a spin would reset it, and this scenario never starts one
+		if (test.type == scenario::reward)
+			_game.showcase(std::numeric_limits<size_t>::max());
+
+		started = last = clock_t::now();
+
+		// the context filters out everything below errors in release builds
+		SDL_LogSetPriority(SDL_LOG_CATEGORY_TEST, SDL_LOG_PRIORITY_INFO);
+	}
+
+	void Run::woke()
+	{
+		if (finished)
+			return;
+
+		// the idle scenario presents next to nothing, so time is also kept here, once per wakeup
+		clock_t::time_point now = clock_t::now();
+		if (!measuring && now - started >= warmup)
+		{
+			measuring   = true;
+			begun       = now;
+			cpu_begun   = cpu();
+			calls_begun = frame->calls();
+		}
+		if (measuring && now - begun >= duration)
+			finish(now);
+	}
+
+	void Run::drive(const Game& _game)
+	{
+		if (finished || test.type != scenario::spin)
+			return;
+
+		starting(_game.view().start);
+	}
+
+	void Run::presented(env::state _state, const graphics::TexturePool& _texture_pool)
+	{
+		clock_t::time_point now = clock_t::now();
+		if (measuring && !finished)
+		{
+			samples[sampled++ % samples_count] = std::chrono::duration<float, std::milli>(now - last).count();
+			result.frames++;
+		}
+		last = now;
+	}
+
+	void Run::finish(clock_t::time_point _now)
+	{
+		finished = true;
+
+		result.ran     = true;
+		result.seconds = std::chrono::duration<double>(_now - begun).count();
+		result.cpu     = cpu() - cpu_begun;
+		result.calls   = frame->calls() - calls_begun;
+
+		// the ring is not needed in order any more, so the percentiles are selected in place
+		size_t count = (size_t)std::min<Uint64>(sampled, samples_count);
+		auto percentile = [&](double _fraction) -> double
+		{
+			if (count == 0)
+				return 0;
+			auto nth = samples.begin() + (ptrdiff_t)std::min(count - 1, (size_t)(_fraction * count));
+			std::nth_element(samples.begin(), nth, samples.begin() + count);
+			return *nth;
+		};
+		result.p50 = percentile(.5);
+		result.p99 = percentile(.99);
+		result.max = percentile(1.);
+
+		SDL_LogInfo(
+			SDL_LOG_CATEGORY_TEST,
+			"bench: %s, %s, %dx%d, %s, %zu threads: %llu frames, p50 %.3f ms, p99 %.3f ms, CPU %.0f%%",
+			name(test.type), test.software ? "software" : "accelerated", test.size.x, test.size.y, test.cabinet, test.threads,
+			(unsigned long long)result.frames, result.p50, result.p99, result.cpu * 100 / std::max(result.seconds, 1e-9)
+		);
+
+		sdl::Event quit = {};
+		quit.type = sdl::EventType::SDL_QUIT;
+		SDL_PushEvent(&quit);
+	}
+
+	auto Run::outcome() const -> const Result&
+	{
+		return result;
+	}
+
+	void write(std::FILE* _file, const std::vector<Case>& _cases, const std::vector<Result>& _results, double _duration)
+	{
+		std::fprintf(_file, "{\n\t\"seconds\": %g,\n\t\"budget_ms\": %.3f,\n\t\"results\": [", _duration, budget);
+
+		for (size_t i = 0; i < _cases.size() && i < _results.size(); i++)
+		{
+			const Case&   test   = _cases[i];
+			const Result& result = _results[i];
+
+			std::fprintf(
+				_file,
+				"%s\n\t\t{\"scenario\": \"%s\", \"renderer\": \"%s\", \"width\": %d, \"height\": %d, \"cabinet\": \"%s\", \"threads\": %zu, \"ran\": %s",
+				i ? "," : "",
+				name(test.type), test.software ? "software" : "accelerated", test.size.x, test.size.y, test.cabinet, test.threads,
+				result.ran ? "true" : "false"
+			);
+			if (result.ran)
+				std::fprintf(
+					_file,
+					", \"frames\": %llu, \"fps\": %.1f, \"cpu_share\": %.3f",
+					(unsigned long long)result.frames, result.frames / std::max(result.seconds, 1e-9), result.cpu / std::max(result.seconds, 1e-9)
+				);
+			// an idle run may present nothing at all, which says nothing about the cost of a frame
+			if (result.ran && result.frames)
+				std::fprintf(
+					_file,
+					", \"frame_ms\": {\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}, \"cpu_ms_per_frame\": %.3f, \"draw_calls_per_frame\": %.1f, \"holds_60fps\": %s",
+					result.p50, result.p99, result.max,
+					result.cpu * 1e3 / result.frames, (double)result.calls / result.frames,
+					result.p99 <= budget ? "true" : "false"
+				);
+			std::fputc('}', _file);
+		}
+
+		std::fputs("\n\t]\n}\n", _file);
+	}
+}
\ No newline at end of file
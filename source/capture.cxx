@@ -0,0 +1,294 @@
+#include "bindings.h"
+#include "graphics.h"
+#include "capture.h"
+
+#include <SDL_log.h>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <string>
+
+namespace slots::capture
+{
+	Recorder::~Recorder()
+	{
+		stop();
+	}
+
+	bool Recorder::start(std::string_view _directory, sdl::Point _size)
+	{
+		if (worker.joinable())
+			return true;
+
+		std::error_code error;
+		std::filesystem::create_directories(std::string(_directory), error);
+		if (error)
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "capture %s: %s", std::string(_directory).data(), error.message().data());
+			return false;
+		}
+
+		directory = _directory;
+		size      = {/*.x =*/ std::max(2, _size.x / scale) & ~1, /*.y =*/ std::max(2, _size.y / scale) & ~1};
+
+		pictures.reserve(capacity);
+		scaled.resize((size_t)size.x * size.y * 3);
+
+		// sized for the window as created, so readbacks only allocate once it is resized
+		for (Readback& readback : readbacks)
+			readback.pixels.reserve((size_t)_size.x * _size.y);
+
+		for (size_t i = 0; i < staging; i++)
+			available.push(i);
+
+		running = true;
+		worker  = std::thread(&Recorder::run, this);
+		return true;
+	}
+
+	void Recorder::stop()
+	{
+		if (!worker.joinable())
+			return;
+		running = false;
+		wakeup.notify();
+		worker.join();
+	}
+
+	void Recorder::presenting(sdl::Renderer* _renderer)
+	{
+		if (!running.load(std::memory_order_relaxed))
+			return;
+
+		clock_t::time_point now = clock_t::now();
+		if (now - last < period)
+			return;
+
+		// the buffer stays reserved across failed reads, so only the worker ever gives buffers back
+		if (reserved == staging && !available.pop(reserved))
+			return;
+
+		sdl::Point output;
+		if (SDL_GetRendererOutputSize(_renderer, &output.x, &output.y) || output.x <= 0 || output.y <= 0)
+			return;
+
+		Readback& readback = readbacks[reserved];
+		readback.pixels.resize((size_t)output.x * output.y);
+		if (SDL_RenderReadPixels(_renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, readback.pixels.data(), output.x * (int)sizeof(Uint32)))
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "capture: %s", SDL_GetError());
+			return;
+		}
+		readback.size = output;
+		readback.time = now;
+
+		filled.push(reserved);
+		wakeup.notify();
+		reserved = staging;
+		last     = now;
+	}
+
+	void Recorder::mark()
+	{
+		if (!running.load(std::memory_order_relaxed))
+			return;
+		if (!marks.push(clock_t::now()))
+			SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "capture: too many clips pending, one skipped");
+		wakeup.notify();
+	}
+
+	void Recorder::run()
+	{
+		for (bool active = true; active;)
+		{
+			active = running.load();
+
+			// frames go into the history before any mark that came after them is written
+			bool busy = false;
+			for (size_t index; filled.pop(index); busy = true)
+			{
+				convert(readbacks[index]);
+				available.push(index);
+			}
+			for (clock_t::time_point mark; marks.pop(mark); busy = true)
+				write(mark);
+
+			// every producer notifies, the timeout only bounds a missed stop
+			if (active && !busy)
+				wakeup.wait(std::chrono::seconds(1));
+		}
+	}
+
+	void Recorder::convert(const Readback& _readback)
+	{
+		const size_t width  = (size_t)size.x;
+		const size_t height = (size_t)size.y;
+
+		// every picture averages the 2x2 source block its centre falls on, whatever the window size is now
+		const size_t source_width  = (size_t)_readback.size.x;
+		const size_t source_height = (size_t)_readback.size.y;
+
+		Uint8* rgb = scaled.data();
+		for (size_t y = 0; y < height; y++)
+		{
+			size_t top    = std::min(y * source_height / height, source_height - 1);
+			size_t bottom = std::min(top + 1, source_height - 1);
+
+			for (size_t x = 0; x < width; x++)
+			{
+				size_t left  = std::min(x * source_width / width, source_width - 1);
+				size_t right = std::min(left + 1, source_width - 1);
+
+				Uint32 pixels[4] = {
+					_readback.pixels[top * source_width + left],
+					_readback.pixels[top * source_width + right],
+					_readback.pixels[bottom * source_width + left],
+					_readback.pixels[bottom * source_width + right],
+				};
+
+				for (int shift : {16, 8, 0})
+				{
+					Uint32 sum = 0;
+					for (Uint32 pixel : pixels)
+						sum += (pixel >> shift) & 0xFF;
+					*rgb++ = (Uint8)((sum + 2) / 4);
+				}
+			}
+		}
+
+		if (pictures.size() < capacity)
+			pictures.emplace_back();
+		Picture& picture = pictures[next];
+		next = (next + 1) % capacity;
+
+		picture.time = _readback.time;
+		picture.planes.resize(width * height * 3 / 2);
+
+		Uint8* luma = picture.planes.data();
+		Uint8* blue = luma + width * height;
+		Uint8* red  = blue + width * height / 4;
+
+		// BT.601 full range in 8.8 fixed point
+		for (size_t i = 0; i < width * height; i++)
+		{
+			const Uint8* pixel = scaled.data() + i * 3;
+			luma[i] = (Uint8)((77 * pixel[0] + 150 * pixel[1] + 29 * pixel[2] + 128) >> 8);
+		}
+
+		for (size_t y = 0; y < height; y += 2)
+			for (size_t x = 0; x < width; x += 2)
+			{
+				int sum[3] = {};
+				for (size_t corner : {y * width + x, y * width + x + 1, (y + 1) * width + x, (y + 1) * width + x + 1})
+					for (size_t channel = 0; channel < 3; channel++)
+						sum[channel] += scaled[corner * 3 + channel];
+
+				int r = sum[0] / 4;
+				int g = sum[1] / 4;
+				int b = sum[2] / 4;
+
+				size_t chroma = (y / 2) * (width / 2) + x / 2;
+				blue[chroma] = (Uint8)std::clamp(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 0, 255);
+				red[chroma]  = (Uint8)std::clamp(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 0, 255);
+			}
+	}
+
+	void Recorder::write(clock_t::time_point _mark)
+	{
+		if (pictures.empty())
+			return;
+
+		// the ring in time order: once full, the oldest picture is the one about to be overwritten
+		size_t count = pictures.size();
+		size_t first = count < capacity ? 0 : next;
+		auto at = [&](size_t _index) -> const Picture& { return pictures[(first + _index) % count]; };
+
+		// marks close together would otherwise write mostly the same seconds again
+		clock_t::time_point begin = std::max<clock_t::time_point>({at(0).time, _mark - window, covered + period});
+		if (begin > _mark)
+			return;
+		covered = _mark;
+
+		auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		std::filesystem::path path = std::filesystem::path(directory) / ("spin-" + std::to_string(milliseconds) + ".y4m");
+
+		std::FILE* file = std::fopen(path.string().data(), "wb");
+		if (!file)
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "capture %s: %s", path.string().data(), std::strerror(errno));
+			return;
+		}
+
+		std::fprintf(file, "YUV4MPEG2 W%d H%d F%zu:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n", size.x, size.y, rate);
+
+		// Pictures are taken only while frames are presented, so idle stretches leave gaps.
+		// Every tick of the clip repeats the newest picture taken before it, which keeps the timing true.
+		size_t index   = 0;
+		size_t written = 0;
+		for (clock_t::time_point tick = begin; tick <= _mark; tick += period)
+		{
+			while (index + 1 < count && at(index + 1).time <= tick)
+				index++;
+			if (at(index).time > tick)
+				continue;
+
+			const std::vector<Uint8>& planes = at(index).planes;
+			std::fputs("FRAME\n", file);
+			std::fwrite(planes.data(), 1, planes.size(), file);
+			written++;
+		}
+
+		if (std::fclose(file))
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "capture %s: %s", path.string().data(), std::strerror(errno));
+		else
+			SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "captured %zu frames into %s", written, path.string().data());
+
+		prune();
+	}
+
+	void Recorder::prune()
+	{
+		struct Clip
+		{
+			std::filesystem::path path;
+			Uint64                size = 0;
+		};
+
+		std::error_code   error;
+		std::vector<Clip> clips;
+		Uint64            total = 0;
+
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+		{
+			std::string name = entry.path().filename().string();
+			if (name.rfind("spin-", 0) != 0 || entry.path().extension() != ".y4m")
+				continue;
+			Uint64 size = entry.file_size(error);
+			if (error)
+				continue;
+			clips.push_back({/*.path =*/ entry.path(), /*.size =*/ size});
+			total += size;
+		}
+
+		// names carry the wall-clock milliseconds, so shorter names are older and equal lengths compare as text
+		auto older = [](const Clip& _left, const Clip& _right)
+		{
+			std::string left  = _left.path.filename().string();
+			std::string right = _right.path.filename().string();
+			return left.size() != right.size() ? left.size() < right.size() : left < right;
+		};
+		std::sort(clips.begin(), clips.end(), older);
+
+		for (size_t i = 0; total > retained && i + 1 < clips.size(); i++)
+		{
+			if (!std::filesystem::remove(clips[i].path, error))
+			{
+				SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "capture %s: %s", clips[i].path.string().data(), error.message().data());
+				continue;
+			}
+			total -= clips[i].size;
+		}
+	}
+}
\ No newline at end of file
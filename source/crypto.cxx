@@ -0,0 +1,316 @@
+#include "bindings.h"
+#include "crypto.h"
+
+#include <SDL_log.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/random.h>
+#include <cerrno>
+#endif
+
+namespace slots::crypto
+{
+	namespace
+	{
+		constexpr Uint32 rounds[64] = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+		};
+
+		constexpr auto rotate(Uint32 _value, int _count) -> Uint32
+		{
+			return (_value >> _count) | (_value << (32 - _count));
+		}
+	}
+
+	Sha256::Sha256() :
+		state({0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}),
+		block()
+	{
+	}
+
+	void Sha256::compress(const Uint8* _block)
+	{
+		Uint32 words[64];
+		for (size_t i = 0; i < 16; i++)
+			words[i] = (Uint32)_block[i * 4] << 24 | (Uint32)_block[i * 4 + 1] << 16 | (Uint32)_block[i * 4 + 2] << 8 | (Uint32)_block[i * 4 + 3];
+		for (size_t i = 16; i < 64; i++)
+		{
+			Uint32 s0 = rotate(words[i - 15], 7) ^ rotate(words[i - 15], 18) ^ (words[i - 15] >> 3);
+			Uint32 s1 = rotate(words[i - 2], 17) ^ rotate(words[i - 2], 19) ^ (words[i - 2] >> 10);
+			words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+		}
+
+		auto [a, b, c, d, e, f, g, h] = state;
+		for (size_t i = 0; i < 64; i++)
+		{
+			Uint32 t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + rounds[i] + words[i];
+			Uint32 t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g; g = f; f = e; e = d + t1;
+			d = c; c = b; b = a; a = t1 + t2;
+		}
+
+		state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+		state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+	}
+
+	void Sha256::update(const void* _data, size_t _size)
+	{
+		const auto* data = static_cast<const Uint8*>(_data);
+		while (_size)
+		{
+			size_t used  = length % block_size;
+			size_t taken = std::min(_size, block_size - used);
+			std::memcpy(block.data() + used, data, taken);
+
+			length += taken;
+			data   += taken;
+			_size  -= taken;
+
+			if (length % block_size == 0)
+				compress(block.data());
+		}
+	}
+
+	auto Sha256::finish() -> digest_t
+	{
+		Uint64 bits = length * 8;
+
+		const Uint8 marker = 0x80;
+		update(&marker, 1);
+
+		const Uint8 zero = 0;
+		while (length % block_size != block_size - 8)
+			update(&zero, 1);
+
+		Uint8 tail[8];
+		for (size_t i = 0; i < 8; i++)
+			tail[i] = (Uint8)(bits >> (56 - i * 8));
+		update(tail, sizeof(tail));
+
+		digest_t digest;
+		for (size_t i = 0; i < digest.size(); i++)
+			digest[i] = (Uint8)(state[i / 4] >> (24 - (i % 4) * 8));
+		return digest;
+	}
+
+	// -----------------------------------------
+
+	namespace
+	{
+		constexpr auto rotate_left(Uint32 _value, int _count) -> Uint32
+		{
+			return (_value << _count) | (_value >> (32 - _count));
+		}
+
+		constexpr void quarter(Uint32& _a, Uint32& _b, Uint32& _c, Uint32& _d)
+		{
+			_a += _b; _d ^= _a; _d = rotate_left(_d, 16);
+			_c += _d; _b ^= _c; _b = rotate_left(_b, 12);
+			_a += _b; _d ^= _a; _d = rotate_left(_d, 8);
+			_c += _d; _b ^= _c; _b = rotate_left(_b, 7);
+		}
+
+		auto little(const Uint8* _bytes) -> Uint32
+		{
+			return (Uint32)_bytes[0] | (Uint32)_bytes[1] << 8 | (Uint32)_bytes[2] << 16 | (Uint32)_bytes[3] << 24;
+		}
+	}
+
+	ChaCha20::ChaCha20(const key_t& _key, const nonce_t& _nonce, Uint32 _counter)
+	{
+		// "expand 32-byte k"
+		state[0] = 0x61707865;
+		state[1] = 0x3320646e;
+		state[2] = 0x79622d32;
+		state[3] = 0x6b206574;
+		for (size_t i = 0; i < 8; i++)
+			state[4 + i] = little(_key.data() + i * 4);
+		state[12] = _counter;
+		for (size_t i = 0; i < 3; i++)
+			state[13 + i] = little(_nonce.data() + i * 4);
+	}
+
+	void ChaCha20::generate(block_t& _block)
+	{
+		auto working = state;
+		for (size_t i = 0; i < 10; i++)
+		{
+			quarter(working[0], working[4], working[8],  working[12]);
+			quarter(working[1], working[5], working[9],  working[13]);
+			quarter(working[2], working[6], working[10], working[14]);
+			quarter(working[3], working[7], working[11], working[15]);
+			quarter(working[0], working[5], working[10], working[15]);
+			quarter(working[1], working[6], working[11], working[12]);
+			quarter(working[2], working[7], working[8],  working[13]);
+			quarter(working[3], working[4], working[9],  working[14]);
+		}
+
+		for (size_t i = 0; i < 16; i++)
+		{
+			Uint32 word = working[i] + state[i];
+			for (size_t j = 0; j < 4; j++)
+				_block[i * 4 + j] = (Uint8)(word >> (j * 8));
+		}
+
+		state[12]++;
+	}
+
+	// -----------------------------------------
+
+	bool Health::feed(Uint8 _sample)
+	{
+		repeated = (repeated && _sample == previous) ? repeated + 1 : 1;
+		previous = _sample;
+
+		if (position == 0)
+		{
+			reference = _sample;
+			matches   = 0;
+		}
+		matches += _sample == reference;
+		position = (position + 1) % window;
+
+		return repeated < repetition_cutoff && matches < proportion_cutoff;
+	}
+
+	bool entropy(Uint8* _buffer, size_t _size)
+	{
+#ifdef __linux__
+		while (_size)
+		{
+			ssize_t read = getrandom(_buffer, _size, 0);
+			if (read < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return false;
+			}
+			_buffer += read;
+			_size   -= read;
+		}
+		return true;
+#else
+		// std::random_device may be a deterministic engine on some targets; one that reports
+		// no entropy is refused, which leaves the stream unhealthy and play halted
+		try
+		{
+			static auto device = std::random_device();
+			if (device.entropy() == 0)
+				return false;
+			for (size_t i = 0; i < _size; i += 4)
+			{
+				Uint32 word = device();
+				std::memcpy(_buffer + i, &word, std::min<size_t>(4, _size - i));
+			}
+			return true;
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+#endif
+	}
+
+	// -----------------------------------------
+
+	Stream::Stream()
+	{
+		running  = true;
+		producer = std::thread(&Stream::run, this);
+	}
+
+	Stream::~Stream()
+	{
+		running = false;
+		refill.notify();
+		if (producer.joinable())
+			producer.join();
+	}
+
+	bool Stream::seed(ChaCha20::key_t& _key)
+	{
+		if (!entropy(_key.data(), _key.size()))
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "outcome stream: the system entropy source is unavailable");
+			return false;
+		}
+		for (Uint8 sample : _key)
+			if (!health.feed(sample))
+			{
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "outcome stream: the system entropy source failed a health test");
+				return false;
+			}
+		return true;
+	}
+
+	void Stream::run()
+	{
+		constexpr size_t per_block = ChaCha20::block_size / sizeof(Uint64);
+
+		ChaCha20::key_t   key   = {};
+		ChaCha20::nonce_t nonce = {};
+		ChaCha20::block_t block = {};
+
+		while (running)
+		{
+			if (!seed(key))
+			{
+				failed = true;
+				return;
+			}
+			auto generator = ChaCha20(key, nonce);
+			key.fill(0);
+
+			for (size_t blocks = 0; running && blocks < rekey;)
+			{
+				if (capacity - words.size() < per_block)
+				{
+					refill.wait(std::chrono::milliseconds(100));
+					continue;
+				}
+
+				generator.generate(block);
+				blocks++;
+
+				for (size_t i = 0; i < per_block; i++)
+				{
+					Uint64 word;
+					std::memcpy(&word, block.data() + i * sizeof(Uint64), sizeof(Uint64));
+					words.push(word);
+				}
+			}
+		}
+		block.fill(0);
+	}
+
+	bool Stream::ready(size_t _count) const
+	{
+		return !failed && words.size() >= _count;
+	}
+
+	bool Stream::take(Uint64* _words, size_t _count)
+	{
+		if (!ready(_count))
+			return false;
+		for (size_t i = 0; i < _count; i++)
+			words.pop(_words[i]);
+		refill.notify();
+		return true;
+	}
+
+	bool Stream::healthy() const
+	{
+		return !failed;
+	}
+}
\ No newline at end of file
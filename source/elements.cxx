@@ -3,21 +3,34 @@
 #include "elements.h"
 #include "utility.h"
 #include "lists.h"
+#include "cabinet.h"
 
+#include <string_view>
+#include <algorithm>
+#include <memory>
+#include <tuple>
 #include <limits>
 #include <random>
 
 namespace slots
 {
-	auto Barrel::index(size_t _i) const -> size_t
+	template <typename _Config>
+	auto Barrel<_Config>::window() const -> const Uint8*
 	{
-		if ((current + _i) < target)
-			return (length - target + current + _i) % length;
-		else
-			return (current + _i - 2) % length;
+		// `current` is always below `length`, so one conditional subtraction replaces the modulo
+		size_t first = current + length - target;
+		first -= length & (0 - size_t(first >= length));
+		return reel.data() + first;
 	}
 
-	void Barrel::init(const graphics::TexturePool& _texture_pool)
+	template <typename _Config>
+	auto Barrel<_Config>::scrolled() const -> float
+	{
+		return size.y * offset / unit;
+	}
+
+	template <typename _Config>
+	void Barrel<_Config>::init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list, const cabinet::strip_t<_Config>& _strip)
 	{
 		static constexpr struct {
 			Uint8 min   = std::numeric_limits<Uint8>::max() / 2;
@@ -25,12 +38,10 @@ namespace slots
 			size_t size = sizeof(Uint8) * 3;
 		} rgb;
 
-		static auto id    = std::uniform_int_distribution<Uint16>(0, rgb.size);
+		static auto id    = std::uniform_int_distribution<Uint16>(0, rgb.size - 1);
 		static auto max   = std::uniform_int_distribution<Uint16>(false, true);
 		static auto color = std::uniform_int_distribution<Uint16>(rgb.min, rgb.max);
 
-		static auto name_id = std::uniform_int_distribution<size_t>(0, slots::env::cats.size() - 1);
-
 		auto normalized = []() -> sdl::Color
 		{
 			Uint8 array[rgb.size];
@@ -43,125 +54,179 @@ namespace slots
 			return {/*.r =*/ r, /*.g =*/ g, /*.b =*/ b, /*.a =*/ rgb.max};
 		};
 
-		for (auto& [id, symbol] : symbols)
+		for (size_t id = 0; id < symbols_count; id++)
+		{
+			glyphs[id] = _texture_pool[util::get(slots::env::cats, id)];
+			colors[id] = normalized();
+		}
+
+		Uint32 weights[length];
+
+		for (size_t i = 0; i < length; i++)
+		{
+			reel[i]    = _strip[i];
+			weights[i] = util::get(slots::env::weights, reel[i]);
+		}
+		std::copy_n(reel.begin(), reel.size() - length, reel.begin() + length);
+
+		stops.assign(weights, length);
+		destination = current;
+
+		for (auto& sprite : sprites)
+			sprite = _list.insert(graphics::RenderList::key(layer::symbols, 0), graphics::Record::kind::sprite);
+		for (auto& border : borders)
+			border = _list.insert(graphics::RenderList::key(layer::borders, 0), graphics::Record::kind::outline);
+	}
+
+	template <typename _Config>
+	void Barrel<_Config>::update(graphics::RenderList& _list)
+	{
+		using util::operator+;
+		using util::operator*;
+		using util::operator+=;
+		using util::operator*=;
+
+		const Uint8* ids = window();
+
+		for (size_t i = 0; i < viewable; i++)
 		{
-			id = util::random(name_id);
-			std::string_view name = util::get(slots::env::cats, id);
-			if (sdl::Texture* texture = _texture_pool[name]; texture)
-			{
-				symbol.ptr   = texture;
-				symbol.color = normalized();
-			}
+			graphics::Texture texture;
+			texture.ptr   = glyphs[ids[i]];
+			texture.color = colors[ids[i]];
+
+			texture.destination = *this;
+			texture.destination.size *= .8F;
+			texture.destination.position += size * .1F;
+			texture.destination.position.y -= size.y;
+			texture.destination.position.y += size.y * i + scrolled();
+			_list.assign(sprites[i], texture);
+
+			graphics::Rect rect = *this;
+			rect.position.y += size.y * i - size.y + scrolled();
+			_list.assign(borders[i], rect, border);
 		}
 	}
 
-	void Barrel::draw(sdl::Renderer* _renderer) const
+	template <typename _Config>
+	void Barrel<_Config>::resolve(Uint64 _entropy)
 	{
-		apply(
-			[this, _renderer](const graphics::Texture& _symbol, size_t _index)
-			{
-				_symbol.draw(_renderer);
-				graphics::Rect rect = *this;
-				rect.position.y += size.y * _index - size.y + size.y / segment * scrolling;
-				graphics::draw(_renderer, rect, border);
-			}
-		);
+		destination = stops(_entropy);
 	}
 
-	void Barrel::update()
+	template <typename _Config>
+	void Barrel<_Config>::accelerate()
 	{
-		apply(
-			[this](graphics::Texture& _texture, size_t _index)
-			{
-				using util::operator+;
-				using util::operator*;
-				using util::operator+=;
-				using util::operator*=;
-				_texture.destination = *this;
-				_texture.destination.size *= .8F;
-				_texture.destination.position += size * .1F;
-				_texture.destination.position.y -= size.y;
-				_texture.destination.position.y += size.y * _index + size.y / segment * scrolling;
-			}
-		);
+		if (gear == top)
+			return;
+
+		// shifts up every `acceleration` frames of the current gear; standing still always shifts
+		if (offset % (profile[gear] * acceleration + !gear) == 0)
+			gear++;
 	}
 
-	void Barrel::accelerate()
+	template <typename _Config>
+	void Barrel<_Config>::spin()
 	{
-		if (scrolling % acceleration == 0)
-			if (segment > segmentation.min)
-			{
-				segment   >>= 1;
-				scrolling >>= 1;
-			}
+		offset += profile[gear];
+
+		current = (current + length - (offset >> precision)) % length;
+		offset &= unit - 1;
 	}
 
-	void Barrel::spin()
+	template <typename _Config>
+	void Barrel<_Config>::decelerate()
 	{
-		if (segment == segmentation.max)
+		if (offset != 0)
 			return;
 
-		scrolling++;
-		if (scrolling == segment)
-		{
-			scrolling = 0;
+		// the reel counts down, and braking always passes the same number of stops,
+		// so at top speed it keeps spinning until it is that far above the resolved one
+		size_t braking_point = (destination + braking) % length;
+		if (gear == top && current != braking_point)
+			return;
 
-			if (current)
-				current--;
-			else
-				current = length - 1;
-		}
+		if (gear)
+			gear--;
 	}
 
-	void Barrel::decelerate()
+	template <typename _Config>
+	bool Barrel<_Config>::stopped() const
 	{
-		if (scrolling == 0)
-			if (segment < segmentation.max)
-				segment <<= 1;
+		return gear == 0;
 	}
 
-	bool Barrel::stopped() const
+	template <typename _Config>
+	bool Barrel<_Config>::accelerated() const
 	{
-		return scrolling == 0 && segment == segmentation.max;
+		return gear == top;
 	}
 
-	bool Barrel::accelerated() const
+	template <typename _Config>
+	auto Barrel<_Config>::symbol() const -> size_t
 	{
-		return segment == segmentation.min;
+		return reel[current];
 	}
 
-	auto Barrel::symbol() const -> size_t
+	template <typename _Config>
+	auto Barrel<_Config>::symbol(size_t _row) const -> size_t
 	{
-		const auto& [id, texture] = symbols[current];
-		return id;
+		// the sprite at index 0 is the one scrolling in above the strip
+		return window()[_row + 1];
 	}
 
-	template <typename _Func, util::require<std::is_invocable_v<_Func, graphics::Texture&>>>
-	void Barrel::apply(_Func _func)
+	template <typename _Config>
+	auto Barrel<_Config>::stop() const -> size_t
 	{
-		for (size_t i = 0; i < viewable; i++)
-			_func(symbols[index(i)].second);
+		return current;
 	}
 
-	template <typename _Func, util::require<std::is_invocable_v<_Func, const graphics::Texture&>>>
-	void Barrel::apply(_Func _func) const
+	template <typename _Config>
+	auto Barrel<_Config>::drift(bool _landed) const -> const char*
 	{
-		for (size_t i = 0; i < viewable; i++)
-			_func(symbols[index(i)].second);
+		if (current >= length)
+			return "position past the end of the reel";
+		if (destination >= length)
+			return "resolved stop past the end of the reel";
+		if (gear > top)
+			return "gear past the top of the profile";
+		if (offset >= unit)
+			return "offset of a whole stop or more";
+		if (gear == 0 && offset != 0)
+			return "standing still between two stops";
+		if (gear != 0 && offset % profile[gear] != 0)
+			return "offset off the step of its gear";
+
+		for (size_t i = 0; i < reel.size(); i++)
+			if (reel[i] >= symbols_count)
+				return "unknown symbol on the reel";
+		if (!std::equal(reel.begin() + length, reel.end(), reel.begin()))
+			return "wrapped stops differ from the start of the reel";
+
+		if (_landed && (gear != 0 || current != destination))
+			return "stopped away from the resolved stop";
+		return nullptr;
 	}
 
-	template <typename _Func, util::require<std::is_invocable_v<_Func, graphics::Texture&, size_t>>>
-	void Barrel::apply(_Func _func)
+	// every variant in cabinet::variants is compiled here, and only here
+	template class Barrel<cabinet::C3x3>;
+	template class Barrel<cabinet::C5x3>;
+	template class Barrel<cabinet::C5x4>;
+	template class Barrel<cabinet::C6x5>;
+
+	namespace
 	{
-		for (size_t i = 0; i < viewable; i++)
-			_func(symbols[index(i)].second, i);
+		template <typename... _Configs>
+		auto make(std::string_view _cabinet, std::tuple<_Configs...>*) -> std::unique_ptr<Reels>
+		{
+			std::unique_ptr<Reels> made;
+			((made = !made && _cabinet == _Configs::name ? std::make_unique<Barrels<_Configs>>() : std::move(made)), ...);
+			return made;
+		}
 	}
 
-	template <typename _Func, util::require<std::is_invocable_v<_Func, const graphics::Texture&, size_t>>>
-	void Barrel::apply(_Func _func) const
+	auto reels(std::string_view _cabinet) -> std::unique_ptr<Reels>
 	{
-		for (size_t i = 0; i < viewable; i++)
-			_func(symbols[index(i)].second, i);
+		return make(_cabinet, (cabinet::variants*)nullptr);
 	}
 
 	// -----------------------------------------
@@ -172,20 +237,18 @@ namespace slots
 			texture.color = _color;
 	}
 
-	void Button::init(const graphics::TexturePool& _texture_pool)
+	void Button::init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list)
 	{
 		for (size_t i = 0; i < type_count; i++)
 			textures[i].ptr = _texture_pool[util::get(env::buttons, i)];
-	}
 
-	void Button::draw(sdl::Renderer* _renderer) const
-	{
-		textures[type].draw(_renderer);
+		sprite = _list.insert(graphics::RenderList::key(layer::buttons, 0), graphics::Record::kind::sprite);
 	}
 
-	void Button::update()
+	void Button::update(graphics::RenderList& _list)
 	{
 		textures[type].destination = *this;
+		_list.assign(sprite, textures[type]);
 	}
 
 	void Button::set(size_t _type)
@@ -234,35 +297,32 @@ namespace slots
 
 	// -----------------------------------------
 
-	void Reward::insert(sdl::Texture* _texture)
+	void Reward::insert(const graphics::Source* _texture)
 	{
-		string.emplace(
-			string.begin(),
-			graphics::Texture{
-				/*.destination =*/ *this,
-				/*.ptr         =*/ _texture,
-			}
-		);
+		// glyphs are prepended, so the ones already there move one place back
+		std::move_backward(string.begin(), string.begin() + used, string.begin() + used + 1);
+		string[0] = graphics::Texture{
+			/*.destination =*/ *this,
+			/*.ptr         =*/ _texture,
+		};
+		used++;
 	}
 
-	void Reward::init(const graphics::TexturePool& _texture_pool)
+	void Reward::init(const graphics::TexturePool& _texture_pool, graphics::RenderList& _list)
 	{
 		for (size_t i = 0; i < alphabet_size; i++)
 			alphabet[i] = _texture_pool[util::get(env::symbols, i)];
-	}
 
-	void Reward::draw(sdl::Renderer* _renderer) const
-	{
-		for (const auto& texture : string)
-			texture.draw(_renderer);
+		for (auto& sprite : sprites)
+			sprite = _list.insert(graphics::RenderList::key(layer::reward, 0), graphics::Record::kind::sprite);
 	}
 
-	void Reward::update()
+	void Reward::update(graphics::RenderList& _list)
 	{
-		string.clear();
+		used = 0;
 
 		for (size_t remaining = value; remaining > 0; remaining /= digits_count)
-			if (sdl::Texture* texture = alphabet[remaining % digits_count])
+			if (const graphics::Source* texture = alphabet[remaining % digits_count])
 				insert(texture);
 
 		if (value == 0)
@@ -270,12 +330,35 @@ namespace slots
 
 		insert(alphabet.back());
 
-		for (size_t i = 0; i < string.size(); i++)
+		for (size_t i = 0; i < used; i++)
 			string[i].destination.position.x += size.x * i - size.x * length();
+
+		for (size_t i = 0; i < capacity; i++)
+		{
+			if (i < used)
+				_list.assign(sprites[i], string[i]);
+			_list.show(sprites[i], shown && i < used);
+		}
+	}
+
+	void Reward::prefetch(const graphics::TexturePool& _texture_pool) const
+	{
+		for (const graphics::Source* glyph : alphabet)
+			_texture_pool.prefetch(glyph);
+	}
+
+	void Reward::show()
+	{
+		shown = true;
+	}
+
+	void Reward::hide()
+	{
+		shown = false;
 	}
 
 	auto Reward::length() const -> size_t
 	{
-		return string.size();
+		return used;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "bindings.h"
+#include "graphics.h"
+#include "interface.h"
+#include "states.h"
+#include "game.h"
+#include "metrics.h"
+
+#include <SDL_log.h>
+
+namespace slots
+{
+	Game::Game(graphics::Frame& _frame, const graphics::TexturePool& _texture_pool, std::string_view _cabinet) :
+		frame(_frame), texture_pool(_texture_pool)
+	{
+		interface.barrels = reels(_cabinet);
+		interface.init(_texture_pool);
+		interface.layout(frame.size);
+		interface.place();
+	}
+
+	auto Game::audio() -> audio::Mixer&
+	{
+		return interface.audio;
+	}
+
+	auto Game::journal() -> journal::Journal&
+	{
+		return interface.journal;
+	}
+
+	void Game::begin()
+	{
+		entered = std::chrono::steady_clock::now();
+
+		state_machine.current()->begin(
+			{
+				/*.interface =*/ interface,
+			}
+		);
+
+		if (State* upcoming = state_machine.upcoming(); upcoming)
+			upcoming->prefetch(
+				{
+					/*.interface    =*/ interface,
+					/*.texture_pool =*/ texture_pool,
+				}
+			);
+	}
+
+	void Game::handle(const sdl::Event& _event)
+	{
+		switch (_event.type)
+		{
+		case sdl::EventType::SDL_WINDOWEVENT:
+			// the new size travels with the event, so the window itself is never asked from here
+			if (_event.window.event == sdl::win::event::RESIZED)
+				state_machine.current()->scale(
+					{
+						/*.interface =*/ interface,
+						/*.scale     =*/ frame.scaling({/*.x =*/ _event.window.data1, /*.y =*/ _event.window.data2}),
+					}
+				);
+			break;
+		case sdl::EventType::SDL_MOUSEBUTTONDOWN:
+			state_machine.current()->handle(
+				{
+					/*.interface =*/ interface,
+					/*.event     =*/ _event,
+				}
+			);
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Game::update()
+	{
+		state_machine.current()->update(
+			{
+				/*.interface =*/ interface,
+				/*.frame     =*/ frame,
+			}
+		);
+
+		bool next = state_machine.current()->end(
+			{
+				/*.interface =*/ interface,
+			}
+		);
+
+		if (next)
+		{
+			metrics::registry().state(state_machine.type(), std::chrono::steady_clock::now() - entered);
+			state_machine.next();
+			begin();
+		}
+	}
+
+	void Game::draw()
+	{
+		state_machine.current()->draw(
+			{
+				/*.interface =*/ interface,
+				/*.frame     =*/ frame,
+			}
+		);
+	}
+
+	auto Game::scene() const -> const graphics::RenderList&
+	{
+		return interface.scene;
+	}
+
+	auto Game::view() const -> const Interface&
+	{
+		return interface;
+	}
+
+	void Game::showcase(size_t _value)
+	{
+		interface.reward.value = _value;
+		interface.reward.show();
+	}
+
+	void Game::clean()
+	{
+		interface.scene.clean();
+	}
+
+	auto Game::state() const -> env::state
+	{
+		return state_machine.type();
+	}
+
+	void press(const Button& _button)
+	{
+		sdl::FRect rect = _button;
+
+		sdl::Event event = {};
+		event.type             = sdl::EventType::SDL_MOUSEBUTTONDOWN;
+		event.common.timestamp = SDL_GetTicks();
+		event.button.button    = SDL_BUTTON_LEFT;
+		event.button.x         = (Sint32)(rect.x + rect.w / 2);
+		event.button.y         = (Sint32)(rect.y + rect.h / 2);
+		if (SDL_PushEvent(&event) < 0)
+			SDL_LogWarn(SDL_LOG_CATEGORY_TEST, "press: %s", SDL_GetError());
+	}
+
+	void Presser::operator()(const Button& _button)
+	{
+		if (!_button.active() || _button.pressed())
+		{
+			waited = 0;
+			return;
+		}
+		if (waited++ % retry == 0)
+			press(_button);
+	}
+}
\ No newline at end of file
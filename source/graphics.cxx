@@ -3,9 +3,20 @@
 #include "utility.h"
 
 #include <SDL_log.h>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
 #include <string_view>
 #include <stdexcept>
 #include <string>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
 
 namespace slots::graphics::exc
 {
@@ -62,103 +73,780 @@ namespace slots::graphics
 
 	// -----------------------------------------
 
-	void Texture::draw(sdl::Renderer* _renderer) const
+	namespace
 	{
-		auto [r, g, b, a]  = color;
-		sdl::FRect dstrect = destination;
-		if (int error = SDL_SetTextureColorMod(ptr, r, g, b))
-			throw exc::sdl_error(error);
-		if (int error = SDL_RenderCopyF(_renderer, ptr, nullptr, &dstrect))
-			throw exc::sdl_error(error);
+		bool equal(const sdl::FRect& _lhs, const sdl::FRect& _rhs)
+		{
+			return _lhs.x == _rhs.x && _lhs.y == _rhs.y && _lhs.w == _rhs.w && _lhs.h == _rhs.h;
+		}
+
+		bool equal(const sdl::Color& _lhs, const sdl::Color& _rhs)
+		{
+			return _lhs.r == _rhs.r && _lhs.g == _rhs.g && _lhs.b == _rhs.b && _lhs.a == _rhs.a;
+		}
 	}
 
-	void Texture::draw(sdl::Renderer* _renderer, sdl::Rect _source) const
+	auto RenderList::insert(Uint32 _key, Record::kind _type) -> handle_t
 	{
-		auto [r, g, b, a]  = color;
-		sdl::FRect dstrect = destination;
-		if (int error = SDL_SetTextureColorMod(ptr, r, g, b))
-			throw exc::sdl_error(error);
-		if (int error = SDL_RenderCopyF(_renderer, ptr, &_source, &dstrect))
-			throw exc::sdl_error(error);
+		handle_t handle = slots.size();
+		slots.push_back(records.size());
+
+		Record record;
+		record.key    = _key;
+		record.type   = _type;
+		record.handle = handle;
+		records.push_back(record);
+
+		sorted  = false;
+		changed = true;
+		return handle;
+	}
+
+	void RenderList::rekey(handle_t _handle, Uint32 _key)
+	{
+		Record& record = records[slots[_handle]];
+		if (record.key == _key)
+			return;
+		record.key = _key;
+		sorted     = false;
+		changed    = true;
+	}
+
+	void RenderList::assign(handle_t _handle, const Texture& _texture)
+	{
+		Record&    record      = records[slots[_handle]];
+		sdl::FRect destination = _texture.destination;
+
+		changed |= record.ptr != _texture.ptr || !equal(record.destination, destination) || !equal(record.color, _texture.color);
+
+		record.ptr         = _texture.ptr;
+		record.destination = destination;
+		record.color       = _texture.color;
+	}
+
+	void RenderList::assign(handle_t _handle, const Rect& _rect, sdl::Color _color)
+	{
+		Record&    record      = records[slots[_handle]];
+		sdl::FRect destination = _rect;
+
+		changed |= !equal(record.destination, destination) || !equal(record.color, _color);
+
+		record.destination = destination;
+		record.color       = _color;
+	}
+
+	void RenderList::show(handle_t _handle, bool _visible)
+	{
+		Record& record = records[slots[_handle]];
+		changed |= record.visible != _visible;
+		record.visible = _visible;
+	}
+
+	auto RenderList::operator[](handle_t _handle) -> Record&
+	{
+		changed = true;
+		return records[slots[_handle]];
+	}
+
+	auto RenderList::operator[](handle_t _handle) const -> const Record&
+	{
+		return records[slots[_handle]];
+	}
+
+	bool RenderList::dirty() const
+	{
+		return changed;
+	}
+
+	void RenderList::clean()
+	{
+		changed = false;
+	}
+
+	void RenderList::sort()
+	{
+		if (sorted)
+			return;
+
+		std::stable_sort(
+			records.begin(),
+			records.end(),
+			[](const Record& _lhs, const Record& _rhs) { return _lhs.key < _rhs.key; }
+		);
+
+		for (size_t i = 0; i < records.size(); i++)
+			slots[records[i].handle] = i;
+
+		sorted = true;
+	}
+
+	auto RenderList::begin() const -> array_t::const_iterator
+	{
+		return records.begin();
+	}
+
+	auto RenderList::end() const -> array_t::const_iterator
+	{
+		return records.end();
+	}
+
+	auto RenderList::size() const -> size_t
+	{
+		return records.size();
+	}
+
+	// -----------------------------------------
+
+	auto Source::pick(sdl::FPoint _size) const -> sdl::Texture*
+	{
+		if (levels.empty())
+			return nullptr;
+		for (auto level = levels.rbegin(); level != levels.rend(); level++)
+			if ((float)level->size.x >= _size.x && (float)level->size.y >= _size.y)
+				return level->texture;
+		return levels.front().texture;
 	}
 
 	// -----------------------------------------
 
+	TexturePool::TexturePool(sdl::Renderer* _renderer) :
+		renderer(_renderer)
+	{
+		loading = true;
+		loader  = std::thread(&TexturePool::load, this);
+	}
+
 	void TexturePool::add(std::string_view _identifier, std::string_view _filename)
 	{
-		sdl::Texture* texture = IMG_LoadTexture(renderer, _filename.data());
-		if (!texture)
-			throw exc::img_error();
-		dict[_identifier.data()] = texture;
+		std::string filename = std::string(_filename);
+
+		// decoding waits for the first draw, but a missing asset fails the start rather than a game
+		sdl::RWops* file = SDL_RWFromFile(filename.data(), "rb");
+		if (!file)
+			throw exc::sdl_error();
+		SDL_RWclose(file);
+
+		dict[std::string(_identifier)].filename = std::move(filename);
+	}
+
+	void TexturePool::prefetch(const Source* _source) const
+	{
+		if (!_source || _source->requested.exchange(true))
+			return;
+		if (!hints.push(_source))
+			_source->requested = false;
+		else
+			pending.notify();
+	}
+
+	bool TexturePool::prepare(const RenderList& _list)
+	{
+		bool queued = false;
+
+		for (const Record& record : _list)
+		{
+			if (!record.visible || record.type != Record::kind::sprite || !record.ptr || !record.ptr->levels.empty())
+				continue;
+
+			// a hint already in flight is not asked for twice; a file that fails to decode stays undrawn
+			if (record.ptr->requested.exchange(true))
+				continue;
+
+			// a full queue leaves the source to the next frame
+			if (!misses.push(record.ptr))
+				record.ptr->requested = false;
+			queued = true;
+		}
+
+		if (queued)
+			pending.notify();
+		return queued;
 	}
 
 	TexturePool::~TexturePool()
 	{
-		for (auto& [filename, texture] : dict)
-			SDL_DestroyTexture(texture);
+		if (watcher.joinable())
+		{
+			watching = false;
+			watcher.join();
+		}
+		if (loader.joinable())
+		{
+			loading = false;
+			pending.notify();
+			loader.join();
+		}
+
+		for (Decoded decoded; reloads.pop(decoded);)
+			SDL_FreeSurface(decoded.surface);
+		for (Decoded decoded; results.pop(decoded);)
+			SDL_FreeSurface(decoded.surface);
+
+		for (auto& [identifier, source] : dict)
+			for (auto& level : source.levels)
+				SDL_DestroyTexture(level.texture);
+	}
+
+	auto TexturePool::operator[](std::string_view _identifier) const -> const Source*
+	{
+		auto found = dict.find(_identifier);
+		return found != dict.end() ? &found->second : nullptr;
+	}
+
+	void TexturePool::watch(std::string_view _directory)
+	{
+		if (watcher.joinable())
+			return;
+		watching = true;
+		watcher  = std::thread(&TexturePool::observe, this, std::string(_directory));
+	}
+
+	void TexturePool::observe(std::string _directory)
+	{
+#ifdef __linux__
+		int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (descriptor < 0)
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "inotify: %s", std::strerror(errno));
+			return;
+		}
+		if (inotify_add_watch(descriptor, _directory.data(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "inotify: %s: %s", _directory.data(), std::strerror(errno));
+			close(descriptor);
+			return;
+		}
+
+		alignas(inotify_event) char buffer[4096];
+
+		while (watching)
+		{
+			pollfd descriptors = {/*.fd =*/ descriptor, /*.events =*/ POLLIN, /*.revents =*/ 0};
+			if (poll(&descriptors, 1, 100) <= 0)
+				continue;
+
+			ssize_t length = read(descriptor, buffer, sizeof(buffer));
+			for (ssize_t offset = 0; offset < length;)
+			{
+				const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				if (!event->len)
+					continue;
+
+				// only files the pool already knows are reloaded; the map itself is never modified here
+				std::string_view name = event->name;
+				for (auto& [identifier, source] : dict)
+				{
+					std::string_view filename = source.filename;
+					if (filename.substr(filename.find_last_of("/\\") + 1) != name)
+						continue;
+					if (!source.requested)
+						break;
+
+					sdl::Surface* surface = IMG_Load(source.filename.data());
+					if (!surface)
+					{
+						SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "%s", IMG_GetError());
+						break;
+					}
+					if (!reloads.push({/*.source =*/ &source, /*.surface =*/ surface, /*.original =*/ true}))
+						SDL_FreeSurface(surface);
+					break;
+				}
+			}
+		}
+
+		close(descriptor);
+#else
+		SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "asset hot reload needs inotify and is only available on Linux");
+#endif
+	}
+
+	bool TexturePool::refresh()
+	{
+		bool installed = false;
+
+		for (Decoded decoded; reloads.pop(decoded); installed = true)
+		{
+			install(decoded);
+			SDL_LogInfo(SDL_LOG_CATEGORY_VIDEO, "reloaded %s", decoded.source->filename.data());
+		}
+
+		for (Decoded decoded; results.pop(decoded); installed = true)
+			install(decoded);
+
+		if (countdown && !--countdown)
+			schedule();
+
+		return installed;
+	}
+
+	void TexturePool::prescale()
+	{
+		for (auto& [identifier, source] : dict)
+			source.demand = {};
+		countdown = settle;
+	}
+
+	void TexturePool::originals(bool _keep)
+	{
+		drop = !_keep;
+	}
+
+	auto TexturePool::textures() const -> size_t
+	{
+		size_t count = 0;
+		for (const auto& [identifier, source] : dict)
+			for (const Source::Level& level : source.levels)
+				count += level.texture != nullptr;
+		return count;
+	}
+
+	void TexturePool::schedule()
+	{
+		bool queued = false;
+
+		for (auto& [identifier, source] : dict)
+		{
+			if (!source.demand.x || !source.demand.y || !source.size.x || !source.size.y)
+				continue;
+
+			// the variant keeps the aspect ratio and is never larger than the original
+			float scale = std::min(1.F, std::max((float)source.demand.x / (float)source.size.x, (float)source.demand.y / (float)source.size.y));
+			sdl::Point size = {
+				/*.x =*/ std::max(1, (int)std::ceil((float)source.size.x * scale)),
+				/*.y =*/ std::max(1, (int)std::ceil((float)source.size.y * scale)),
+			};
+			bool original = size.x == source.size.x && size.y == source.size.y;
+
+			auto matches = [&](const Source::Level& _level) { return original ? _level.original : _level.size.x == size.x && _level.size.y == size.y; };
+			if (std::any_of(source.levels.begin(), source.levels.end(), matches))
+				continue;
+
+			if (!jobs.push({/*.source =*/ &source, /*.size =*/ size, /*.original =*/ original}))
+				SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "prescale queue is full, %s skipped", source.filename.data());
+			else
+				queued = true;
+		}
+
+		if (queued)
+			pending.notify();
+	}
+
+	void TexturePool::load()
+	{
+		for (Job job; loading;)
+		{
+			// misses and hints are whole originals for sources that were never loaded; misses are on screen already
+			if (const Source* miss; misses.pop(miss))
+				job = {/*.source =*/ const_cast<Source*>(miss), /*.size =*/ {}, /*.original =*/ true};
+			else if (const Source* hint; hints.pop(hint))
+				job = {/*.source =*/ const_cast<Source*>(hint), /*.size =*/ {}, /*.original =*/ true};
+			else if (!jobs.pop(job))
+			{
+				// every producer signals after queueing, so the timeout is only a backstop
+				pending.wait(std::chrono::seconds(1));
+				continue;
+			}
+
+			sdl::Surface* surface = IMG_Load(job.source->filename.data());
+			if (!surface)
+			{
+				SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "%s", IMG_GetError());
+				continue;
+			}
+
+			if (!job.original)
+			{
+				// linear stretching wants both sides in the same 32-bit format
+				sdl::Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+				SDL_FreeSurface(surface);
+				surface = nullptr;
+
+				sdl::Surface* scaled = converted ? SDL_CreateRGBSurfaceWithFormat(0, job.size.x, job.size.y, 32, SDL_PIXELFORMAT_ARGB8888) : nullptr;
+				if (scaled && SDL_SoftStretchLinear(converted, nullptr, scaled, nullptr) == 0)
+					surface = scaled;
+				else if (scaled)
+					SDL_FreeSurface(scaled);
+				if (converted)
+					SDL_FreeSurface(converted);
+
+				if (!surface)
+				{
+					SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "%s: %s", job.source->filename.data(), SDL_GetError());
+					continue;
+				}
+			}
+
+			if (!results.push({/*.source =*/ job.source, /*.surface =*/ surface, /*.original =*/ job.original}))
+				SDL_FreeSurface(surface);
+			// an idle loop would otherwise install the batch only when its wait runs out
+			else if (misses.empty() && hints.empty())
+				wake();
+		}
+	}
+
+	void TexturePool::install(const Decoded& _decoded)
+	{
+		Source& source = *_decoded.source;
+
+		sdl::Texture* texture = SDL_CreateTextureFromSurface(renderer, _decoded.surface);
+		sdl::Point    size    = {/*.x =*/ _decoded.surface->w, /*.y =*/ _decoded.surface->h};
+		SDL_FreeSurface(_decoded.surface);
+		if (!texture)
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "%s", SDL_GetError());
+			return;
+		}
+
+		// a new original invalidates every variant made from the previous one
+		auto stale = [&](const Source::Level& _level) { return _decoded.original || !_level.original || drop; };
+		for (auto& level : source.levels)
+			if (stale(level))
+				SDL_DestroyTexture(level.texture);
+		source.levels.erase(std::remove_if(source.levels.begin(), source.levels.end(), stale), source.levels.end());
+
+		Source::Level level = {/*.size =*/ size, /*.texture =*/ texture, /*.original =*/ _decoded.original};
+		auto larger = [&](const Source::Level& _other) { return _other.size.x >= size.x; };
+		source.levels.insert(std::find_if_not(source.levels.begin(), source.levels.end(), larger), level);
+
+		if (_decoded.original)
+		{
+			source.size = size;
+			countdown   = settle;
+		}
+	}
+
+	// -----------------------------------------
+
+	bool Command::operator==(const Command& _other) const
+	{
+		return type == _other.type && texture == _other.texture && ptr == _other.ptr && equal(color, _other.color) && equal(destination, _other.destination);
+	}
+
+	bool Command::operator!=(const Command& _other) const
+	{
+		return !(*this == _other);
+	}
+
+	void DisplayList::push(const Command& _command)
+	{
+		commands.push_back(_command);
+	}
+
+	void DisplayList::clear()
+	{
+		commands.clear();
+	}
+
+	auto DisplayList::common(const DisplayList& _other) const -> size_t
+	{
+		size_t count = 0;
+		for (size_t i = 0; i < std::min(commands.size(), _other.commands.size()); i++)
+			count += commands[i] == _other.commands[i];
+		return count;
+	}
+
+	void DisplayList::replay(sdl::Renderer* _renderer) const
+	{
+		for (const Command& command : commands)
+			submit(_renderer, command);
+	}
+
+	void DisplayList::submit(sdl::Renderer* _renderer, const Command& _command)
+	{
+		auto [r, g, b, a] = _command.color;
+		switch (_command.type)
+		{
+		case Command::kind::clear:
+			if (int error = SDL_SetRenderDrawColor(_renderer, r, g, b, a))
+				throw exc::sdl_error(error);
+			SDL_RenderClear(_renderer);
+			break;
+		case Command::kind::sprite:
+			if (!_command.texture)
+				break;
+			if (int error = SDL_SetTextureColorMod(_command.texture, r, g, b))
+				throw exc::sdl_error(error);
+			if (int error = SDL_RenderCopyF(_renderer, _command.texture, nullptr, &_command.destination))
+				throw exc::sdl_error(error);
+			break;
+		case Command::kind::outline:
+			SDL_SetRenderDrawColor(_renderer, r, g, b, a);
+			SDL_RenderDrawRectF(_renderer, &_command.destination);
+			break;
+		case Command::kind::fill:
+			SDL_SetRenderDrawColor(_renderer, r, g, b, a);
+			SDL_RenderFillRectF(_renderer, &_command.destination);
+			break;
+		case Command::kind::clip:
+		{
+			const sdl::FRect& rect = _command.destination;
+
+			int left   = (int)std::floor(rect.x);
+			int top    = (int)std::floor(rect.y);
+			int right  = (int)std::ceil(rect.x + rect.w);
+			int bottom = (int)std::ceil(rect.y + rect.h);
+
+			sdl::Rect area = {/*.x =*/ left, /*.y =*/ top, /*.w =*/ right - left, /*.h =*/ bottom - top};
+			if (int error = SDL_RenderSetClipRect(_renderer, &area))
+				throw exc::sdl_error(error);
+			break;
+		}
+		case Command::kind::unclip:
+			if (int error = SDL_RenderSetClipRect(_renderer, nullptr))
+				throw exc::sdl_error(error);
+			break;
+		}
+	}
+
+	void DisplayList::dump(std::FILE* _file) const
+	{
+		static constexpr const char* names[] = {"clear", "sprite", "outline", "fill", "clip", "unclip"};
+
+		for (const Command& command : commands)
+		{
+			const sdl::FRect& rect = command.destination;
+			std::fprintf(
+				_file,
+				"%-7s %8.2f %8.2f %8.2f %8.2f #%02x%02x%02x%02x %s\n",
+				names[static_cast<Uint8>(command.type)],
+				rect.x, rect.y, rect.w, rect.h,
+				command.color.r, command.color.g, command.color.b, command.color.a,
+				command.ptr ? command.ptr->filename.data() : "-"
+			);
+		}
+	}
+
+	auto DisplayList::begin() const -> array_t::const_iterator
+	{
+		return commands.begin();
 	}
 
-	auto TexturePool::operator[](std::string_view _identifier) const -> sdl::Texture*
+	auto DisplayList::end() const -> array_t::const_iterator
 	{
-		if (util::contains(dict, _identifier.data()))
-			return dict.at(_identifier.data());
-		return nullptr;
+		return commands.end();
+	}
+
+	auto DisplayList::size() const -> size_t
+	{
+		return commands.size();
 	}
 
 	// -----------------------------------------
 
-	auto Frame::scaling() const -> sdl::FPoint
+	auto Frame::scaling(sdl::Point _window) const -> sdl::FPoint
 	{
-		sdl::Point current;
-		SDL_GetWindowSize(window, &current.x, &current.y);
 		return {
-			/*.x =*/ (float)current.x / (float)size.x,
-			/*.y =*/ (float)current.y / (float)size.y
+			/*.x =*/ (float)_window.x / (float)size.x,
+			/*.y =*/ (float)_window.y / (float)size.y
 		};
 	}
 
-	void Frame::present() const
+	bool Frame::culled(const sdl::FRect& _rect) const
 	{
-		SDL_RenderPresent(renderer);
+		return !clips.empty() && !SDL_HasIntersectionF(&clips.back(), &_rect);
 	}
 
-	void Frame::clear(sdl::Color _color) const
+	void Frame::emit(const Command& _command)
 	{
-		if (int error = SDL_SetRenderDrawColor(renderer, _color.r, _color.g, _color.b, _color.a))
-			throw exc::sdl_error(error);
-		SDL_RenderClear(renderer);
+		if (recording)
+			recorded.push(_command);
+		else
+		{
+			DisplayList::submit(renderer, _command);
+			issued++;
+		}
+	}
+
+	void Frame::confine()
+	{
+		Command command;
+		command.type = clips.empty() ? Command::kind::unclip : Command::kind::clip;
+		if (!clips.empty())
+			command.destination = clips.back();
+		emit(command);
+	}
+
+	void Frame::clip(const sdl::FRect& _rect)
+	{
+		sdl::FRect rect = _rect;
+		if (!clips.empty())
+			if (!SDL_IntersectFRect(&clips.back(), &_rect, &rect))
+				rect = {/*.x =*/ _rect.x, /*.y =*/ _rect.y, /*.w =*/ 0, /*.h =*/ 0};
+		clips.push_back(rect);
+		confine();
+	}
+
+	void Frame::unclip()
+	{
+		if (clips.empty())
+			return;
+		clips.pop_back();
+		confine();
+	}
+
+	void Frame::draw(const RenderList& _list)
+	{
+		// a draw that threw halfway may have left its clips behind
+		clips.clear();
+
+		for (const Record& record : _list)
+		{
+			if (!record.visible)
+				continue;
+
+			switch (record.type)
+			{
+			case Record::kind::clip:
+				clip(record.destination);
+				continue;
+			case Record::kind::unclip:
+				unclip();
+				continue;
+			default:
+				if (culled(record.destination))
+					continue;
+				break;
+			}
+
+			Command command;
+			command.color       = record.color;
+			command.destination = record.destination;
+
+			switch (record.type)
+			{
+			case Record::kind::sprite:
+			{
+				if (!record.ptr)
+					continue;
+
+				const Source& source = *record.ptr;
+				source.demand.x = std::max(source.demand.x, (int)std::ceil(record.destination.w));
+				source.demand.y = std::max(source.demand.y, (int)std::ceil(record.destination.h));
+
+				command.type    = Command::kind::sprite;
+				command.ptr     = record.ptr;
+				command.texture = source.pick({/*.x =*/ record.destination.w, /*.y =*/ record.destination.h});
+				if (!command.texture)
+					continue;
+				break;
+			}
+			case Record::kind::outline:
+				command.type = Command::kind::outline;
+				break;
+			case Record::kind::fill:
+				command.type = Command::kind::fill;
+				break;
+			default:
+				continue;
+			}
+
+			emit(command);
+		}
+
+		while (!clips.empty())
+			unclip();
 	}
 
-	void Frame::clear() const
+	void Frame::present()
 	{
-		if (int error = SDL_RenderClear(renderer))
+		if (!recording)
+		{
+			if (observer)
+				observer->presenting(renderer);
+			SDL_RenderPresent(renderer);
+			return;
+		}
+
+		last.commands = recorded.size();
+		last.common   = recorded.common(submitted);
+		last.skipped  = !stale && last.common == last.commands && last.commands == submitted.size();
+
+		// the window still shows exactly these commands, so there is nothing to send
+		if (!last.skipped)
+		{
+			recorded.replay(renderer);
+			issued += recorded.size();
+			if (observer)
+				observer->presenting(renderer);
+			SDL_RenderPresent(renderer);
+			std::swap(recorded, submitted);
+			stale = false;
+		}
+		recorded.clear();
+	}
+
+	void Frame::clear(sdl::Color _color)
+	{
+		Command command;
+		command.type  = Command::kind::clear;
+		command.color = _color;
+		emit(command);
+	}
+
+	void Frame::clear()
+	{
+		Command command;
+		command.type = Command::kind::clear;
+		if (int error = SDL_GetRenderDrawColor(renderer, &command.color.r, &command.color.g, &command.color.b, &command.color.a))
 			throw exc::sdl_error(error);
+		emit(command);
 	}
 
-	// -----------------------------------------
+	void Frame::record(bool _enabled)
+	{
+		recording = _enabled;
+		recorded.clear();
+		submitted.clear();
+		stale = true;
+	}
 
-	void draw(sdl::Renderer* _renderer, const Rect& _rect, sdl::Color _color)
+	void Frame::invalidate()
 	{
-		auto [r, g, b, a] = _color;
-		sdl::FRect rect = _rect;
-		SDL_SetRenderDrawColor(_renderer, r, g, b, a);
-		SDL_RenderDrawRectF(_renderer, &rect);
+		stale = true;
 	}
 
-	void fill(sdl::Renderer* _renderer, const Rect& _rect, sdl::Color _color)
+	void Frame::observe(Observer* _observer)
 	{
-		auto [r, g, b, a] = _color;
-		sdl::FRect rect = _rect;
-		SDL_SetRenderDrawColor(_renderer, r, g, b, a);
-		SDL_RenderFillRectF(_renderer, &rect);
+		observer = _observer;
 	}
 
+	auto Frame::submission() const -> const Submission&
+	{
+		return last;
+	}
+
+	auto Frame::calls() const -> Uint64
+	{
+		return issued;
+	}
+
+	auto Frame::display() const -> const DisplayList&
+	{
+		return submitted;
+	}
+
+	// -----------------------------------------
+
 	auto motion(const sdl::Event& _event) -> sdl::FPoint
 	{
 		return {/*.x =*/ (float)_event.motion.x, /*.y =*/ (float)_event.motion.y};
 	}
 
-	void context(const WindowData& _window_data, const type::textures& _textures, type::function _function)
+	void wake()
+	{
+		static const Uint32 type = SDL_RegisterEvents(1);
+		if (type == (Uint32)-1)
+			return;
+
+		sdl::Event event = {};
+		event.type = type;
+		SDL_PushEvent(&event);
+	}
+
+	void context(const WindowData& _window_data, const type::textures& _textures, const type::function& _function)
 	{
 		sdl::Window*   window   = nullptr;
 		sdl::Renderer* renderer = nullptr;
@@ -178,6 +866,11 @@ namespace slots::graphics
 			if (!window)
 				throw exc::sdl_error();
 
+			// records of the render list arrive in z-order, so consecutive copies batch well
+			SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
+			// prescaled levels are close to their drawn size, linear filtering covers the rest
+			SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+
 			renderer = SDL_CreateRenderer(window, -1, _window_data.flags.renderer);
 			if (!renderer)
 				throw exc::sdl_error();
@@ -3,21 +3,33 @@
 #include "elements.h"
 #include "interface.h"
 
+#include <algorithm>
+
 namespace slots
 {
 	void Interface::init(const graphics::TexturePool& _texture_pool)
 	{
-		barrels.init(_texture_pool);
-		start.init(_texture_pool);
+		barrels->init(_texture_pool, scene);
+		start.init(_texture_pool, scene);
 		start.set(true);
-		stop.init(_texture_pool);
+		stop.init(_texture_pool, scene);
 		stop.set(false);
-		reward.init(_texture_pool);
+		reward.init(_texture_pool, scene);
+		scene.sort();
+	}
+
+	void Interface::update()
+	{
+		barrels->update(scene);
+		start.update(scene);
+		stop.update(scene);
+		reward.update(scene);
+		scene.sort();
 	}
 
 	void Interface::place()
 	{
-		(graphics::Rect&)(barrels) = parameters.barrel;
+		(graphics::Rect&)(*barrels) = parameters.barrel;
 		(graphics::Rect&)(start)   = parameters.start;
 		(graphics::Rect&)(stop)    = parameters.stop;
 		(graphics::Rect&)(reward)  = parameters.reward;
@@ -25,10 +37,11 @@ namespace slots
 
 	void Interface::layout(int _x, int _y)
 	{
-		float unit = _x * .1F;
+		// taller cabinets shrink the stops so the strip and the reward below it still fit
+		float unit = std::min(_x * .1F, _y / (barrels->rows() + 1.F));
 
-		float barrels_width  = barrels_count * unit;
-		float barrels_height = Barrel::strip * unit;
+		float barrels_width  = barrels->count() * unit;
+		float barrels_height = barrels->rows() * unit;
 
 		float height = (_y - barrels_height - unit) / 2;
 		float width  = (_x - unit * 2 - barrels_width) / 3;
@@ -62,7 +75,7 @@ namespace slots
 
 	void Interface::scale(sdl::FPoint _scale)
 	{
-		barrels.scaling = _scale;
+		barrels->scaling = _scale;
 		start.scaling   = _scale;
 		stop.scaling    = _scale;
 		reward.scaling  = _scale;
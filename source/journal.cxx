@@ -0,0 +1,282 @@
+#include "bindings.h"
+#include "crypto.h"
+#include "journal.h"
+
+#include <SDL_log.h>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace slots::journal
+{
+	namespace
+	{
+		void put(Uint8*& _cursor, Uint64 _value, size_t _bytes)
+		{
+			for (size_t i = 0; i < _bytes; i++)
+				*_cursor++ = (Uint8)(_value >> (i * 8));
+		}
+
+		bool sync(std::FILE* _file)
+		{
+#ifdef _WIN32
+			return _commit(_fileno(_file)) == 0;
+#else
+			return fsync(fileno(_file)) == 0;
+#endif
+		}
+
+		// shorter than the header and agreeing with it as far as it goes, so no record was ever written
+		bool headless(const std::string& _path)
+		{
+			std::FILE* file = std::fopen(_path.data(), "rb");
+			if (!file)
+				return false;
+
+			char   header[sizeof(Journal::magic)];
+			size_t read = std::fread(header, 1, sizeof(header), file);
+			bool   end  = std::fgetc(file) == EOF;
+			std::fclose(file);
+
+			return end && read < sizeof(header) && std::memcmp(header, Journal::magic, read) == 0;
+		}
+	}
+
+	Journal::~Journal()
+	{
+		close();
+	}
+
+	auto Journal::encode(Uint64 _sequence, const Entry& _entry) -> body_t
+	{
+		body_t body;
+		Uint8* cursor = body.data();
+
+		put(cursor, _sequence, 8);
+		put(cursor, _entry.timestamp, 8);
+		put(cursor, _entry.reward, 8);
+		for (char letter : _entry.cabinet)
+			put(cursor, (Uint8)letter, 1);
+		put(cursor, _entry.strips, 8);
+		put(cursor, _entry.count, 1);
+		for (Uint16 stop : _entry.stops)
+			put(cursor, stop, 2);
+
+		return body;
+	}
+
+	auto Journal::link(const digest_t& _previous, const body_t& _body) -> digest_t
+	{
+		crypto::Sha256 hash;
+		hash.update(_previous.data(), _previous.size());
+		hash.update(_body.data(), _body.size());
+		return hash.finish();
+	}
+
+	auto Journal::origin() -> digest_t
+	{
+		crypto::Sha256 hash;
+		hash.update(magic, sizeof(magic));
+		return hash.finish();
+	}
+
+	auto Journal::verify(std::string_view _path) -> Audit
+	{
+		Audit audit;
+
+		std::FILE* file = std::fopen(std::string(_path).data(), "rb");
+		if (!file)
+			return audit;
+
+		char header[sizeof(magic)];
+		if (std::fread(header, 1, sizeof(header), file) != sizeof(header) || std::memcmp(header, magic, sizeof(magic)))
+		{
+			std::fclose(file);
+			return audit;
+		}
+
+		audit.intact = true;
+		audit.head   = origin();
+
+		for (record_t record;;)
+		{
+			size_t read = std::fread(record.data(), 1, record.size(), file);
+			if (read != record.size())
+			{
+				audit.torn = read != 0;
+				break;
+			}
+
+			body_t body;
+			std::copy_n(record.begin(), body_size, body.begin());
+
+			Uint64 sequence = 0;
+			for (size_t i = 0; i < 8; i++)
+				sequence |= (Uint64)body[i] << (i * 8);
+
+			digest_t expected = link(audit.head, body);
+			if (sequence != audit.records || !std::equal(expected.begin(), expected.end(), record.begin() + body_size))
+			{
+				audit.intact = false;
+				break;
+			}
+
+			audit.head = expected;
+			audit.records++;
+		}
+
+		std::fclose(file);
+		return audit;
+	}
+
+	bool Journal::open(std::string_view _path)
+	{
+		if (file)
+			return true;
+
+		path = _path;
+
+		std::error_code error;
+		if (std::filesystem::exists(path, error) && !headless(path))
+		{
+			Audit audit = verify(path);
+			if (!audit.intact)
+			{
+				// appending to a broken chain would hide where it was broken
+				SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "journal %s fails verification after %llu records, not appending", path.data(), (unsigned long long)audit.records);
+				return false;
+			}
+			if (audit.torn)
+			{
+				SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "journal %s ends in a torn record, truncated to %llu records", path.data(), (unsigned long long)audit.records);
+				std::filesystem::resize_file(path, sizeof(magic) + audit.records * size, error);
+				if (error)
+				{
+					SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "journal %s: %s", path.data(), error.message().data());
+					return false;
+				}
+			}
+
+			sequence = audit.records;
+			chain    = audit.head;
+			file     = std::fopen(path.data(), "ab");
+		}
+		else
+		{
+			if (!error && std::filesystem::exists(path, error))
+				SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "journal %s has a torn header and no records, started over", path.data());
+
+			sequence = 0;
+			chain    = origin();
+			file     = std::fopen(path.data(), "wb");
+			if (file && (std::fwrite(magic, 1, sizeof(magic), file) != sizeof(magic) || std::fflush(file) || !sync(file)))
+			{
+				std::fclose(file);
+				file = nullptr;
+			}
+		}
+
+		if (!file)
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "journal %s: %s", path.data(), std::strerror(errno));
+			return false;
+		}
+
+		batch.reserve(entries.capacity());
+
+		running = true;
+		writer  = std::thread(&Journal::run, this);
+		return true;
+	}
+
+	void Journal::close()
+	{
+		if (writer.joinable())
+		{
+			running = false;
+			writer.join();
+		}
+		if (file)
+		{
+			std::fclose(file);
+			file = nullptr;
+		}
+	}
+
+	bool Journal::append(const Entry& _entry)
+	{
+		if (!file)
+			return true;
+		if (failed())
+			return false;
+
+		// the game thread never waits for the disk; a full ring means it is far behind, and the record is lost
+		if (entries.push(_entry))
+			return true;
+
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "journal %s: queue is full, record lost", path.data());
+		broken.store(true, std::memory_order_release);
+		return false;
+	}
+
+	bool Journal::failed() const
+	{
+		return broken.load(std::memory_order_acquire);
+	}
+
+	void Journal::run()
+	{
+		while (running)
+		{
+			std::this_thread::sleep_for(window);
+			commit();
+		}
+		commit();
+	}
+
+	void Journal::commit()
+	{
+		// the chain moves on only once the records behind it are on disk
+		Uint64   next = sequence;
+		digest_t head = chain;
+
+		batch.clear();
+		for (Entry entry; entries.pop(entry);)
+		{
+			// after a failed write nothing more is written, so the file ends on the last record that made it;
+			// records queued before a full ring are written as usual
+			if (stuck)
+				continue;
+
+			body_t body = encode(next++, entry);
+			head = link(head, body);
+
+			record_t& record = batch.emplace_back();
+			std::copy(body.begin(), body.end(), record.begin());
+			std::copy(head.begin(), head.end(), record.begin() + body_size);
+		}
+
+		if (batch.empty())
+			return;
+
+		// one write and one sync for everything that arrived during the window
+		bool written = std::fwrite(batch.data(), sizeof(record_t), batch.size(), file) == batch.size();
+		if (!written || std::fflush(file) || !sync(file))
+		{
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "journal %s: %s, no more spins are recorded", path.data(), std::strerror(errno));
+			broken.store(true, std::memory_order_release);
+			stuck = true;
+			return;
+		}
+
+		sequence = next;
+		chain    = head;
+	}
+}
\ No newline at end of file
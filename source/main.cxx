@@ -1,128 +1,879 @@
 
 #include "bindings.h"
 #include "graphics.h"
-#include "interface.h"
-#include "states.h"
+#include "utility.h"
+#include "game.h"
+#include "metrics.h"
+#include "journal.h"
+#include "capture.h"
+#include "cabinet.h"
+#include "allocations.h"
+#include "soak.h"
+#include "bench.h"
 #include "lists.h"
 
 #include <SDL2/SDL_main.h>
 
+#include <algorithm>
+#include <exception>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <atomic>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <string_view>
+#include <vector>
 
-void loop(const slots::graphics::Frame& _frame, const slots::graphics::TexturePool& _texture_pool)
+namespace assets
 {
-	struct {
-		using point_t = std::chrono::time_point<std::chrono::high_resolution_clock>;
-		using unit_t  = std::chrono::nanoseconds;
+	static constexpr auto directory = "../assets/";
+}
+
+namespace tex
+{
+	auto pair(std::string_view _identifier) -> slots::graphics::type::textures::value_type
+	{
+		return {_identifier.data(), assets::directory + std::string(_identifier) + ".png"};
+	}
+}
+
+namespace snd
+{
+	auto path(std::string_view _identifier) -> std::string
+	{
+		return assets::directory + std::string(_identifier) + ".wav";
+	}
+}
+
+static struct {
+	// polls input as late as the measured frame cost allows instead of right after the previous present
+	bool late_latch    = false;
+	// runs simulation and rendering on the main thread, one after the other
+	bool single_thread = false;
+	// watches the assets and swaps rewritten textures in between frames
+	bool hot_reload    = false;
+	// keeps only the prescaled variants of the textures resident
+	bool lod_drop      = false;
+	// Prometheus text file rewritten every few seconds; empty keeps the export off
+	std::string_view metrics = {};
+	// hash-chained record of every resolved spin; empty keeps the journal off
+	std::string_view journal = {};
+	// blocks on input instead of redrawing an unchanged scene 60 times a second
+	bool idle = true;
+	// draws into a display list and submits it only when it differs from the one on screen
+	bool record = false;
+	// every submitted display list, as text; empty keeps the dump off
+	std::string_view dump = {};
+	// directory for clips of the seconds before each reward; empty keeps capture off
+	std::string_view capture = {};
+	// reels and rows, one of the variants compiled in
+	std::string_view cabinet = slots::cabinet::fallback;
+	// spins of the headless training scenario; zero runs the game
+	size_t train = 0;
+	// spins of the headless soak run through the serial loop; zero runs the game
+	size_t soak = 0;
+	// JSON file the benchmark matrix is written to; empty runs the game
+	std::string_view bench = {};
+	// measured per combination of the matrix, after a short warmup
+	double bench_seconds = 3;
+	// the loop never sleeps to hold the frame rate
+	bool uncapped = false;
+} options;
+
+// what main returns once the window is closed
+static int status = 0;
+
+// longest an idle loop sleeps without input, so background work such as texture reloads still lands
+static constexpr auto idle_period = std::chrono::milliseconds(250);
+
+struct Pacing
+{
+	using clock_t = std::chrono::high_resolution_clock;
+	using point_t = clock_t::time_point;
+	using unit_t  = std::chrono::nanoseconds;
+
+	const size_t fps = 60;
+	const unit_t duration = std::chrono::duration_cast<unit_t>(std::chrono::seconds(1)) / 60;
+	const unit_t margin   = std::chrono::milliseconds(2);
+
+	point_t start;
+	point_t latch;
+	unit_t  work = {};
+
+	void begin()
+	{
+		start = clock_t::now();
+
+		if (options.late_latch)
+			std::this_thread::sleep_for(std::max(duration - work - margin, unit_t::zero()));
+
+		latch = clock_t::now();
+	}
+
+	// restarts the frame after an idle wait, without the late-latch sleep
+	void resume()
+	{
+		start = latch = clock_t::now();
+	}
+
+	void end()
+	{
+		point_t now = clock_t::now();
+		work = (work * 7 + (now - latch)) / 8;
+
+		// training, soak and benchmark runs drive the loop as fast as it goes, so they never wait for the next frame
+		if (!options.uncapped)
+			std::this_thread::sleep_for(std::max(duration - (now - start), unit_t::zero()));
+	}
+};
+
+struct Latency
+{
+	const size_t period = 16;
+
+	Uint32 pending = 0;
+	bool   input   = false;
+
+	size_t count = 0;
+	Uint64 total = 0;
+	Uint32 worst = 0;
+
+	// oldest input consumed by this frame; it becomes visible with the next present
+	void consume(Uint32 _timestamp)
+	{
+		if (!input || _timestamp < pending)
+			pending = _timestamp;
+		input = true;
+	}
+
+	void present()
+	{
+		if (!input)
+			return;
+
+		Uint32 latency = SDL_GetTicks() - pending;
+		input = false;
+
+		count++;
+		total += latency;
+		worst = std::max(worst, latency);
+
+		if (count % period == 0)
+			SDL_LogInfo(SDL_LOG_CATEGORY_INPUT, "input to present: avg %.1f ms, max %u ms over %zu inputs", (double)total / count, worst, count);
+	}
+};
+
+// time between consecutive presents, as the player sees it
+struct Timing
+{
+	using clock_t = std::chrono::steady_clock;
+	using unit_t  = std::chrono::nanoseconds;
+
+	const unit_t budget = std::chrono::duration_cast<unit_t>(std::chrono::seconds(1)) / 60;
+
+	clock_t::time_point last = {};
+	bool started = false;
+
+	void present()
+	{
+		auto now = clock_t::now();
+		if (started)
+			slots::metrics::registry().frame(now - last, budget);
+		last    = now;
+		started = true;
+	}
+
+	// the next present follows an idle gap, which is not a dropped frame
+	void pause()
+	{
+		started = false;
+	}
+};
+
+// any change of the drawable size makes the current texture levels stale
+bool resized(const sdl::Event& _event)
+{
+	return _event.type == sdl::EventType::SDL_WINDOWEVENT && _event.window.event == sdl::win::event::SIZE_CHANGED;
+}
+
+// the window was exposed, resized or otherwise needs its contents again
+bool damaged(const sdl::Event& _event)
+{
+	return _event.type == sdl::EventType::SDL_WINDOWEVENT;
+}
+
+// reports what each recorded present did: into the metrics and, if asked for, into the dump
+struct Recording
+{
+	std::FILE* file  = nullptr;
+	size_t     frame = 0;
+
+	Recording()
+	{
+		if (options.dump.empty())
+			return;
+		file = std::fopen(options.dump.data(), "w");
+		if (!file)
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s", options.dump.data(), std::strerror(errno));
+	}
+
+	~Recording()
+	{
+		if (file)
+			std::fclose(file);
+	}
 
-		const size_t fps = 60;
-		const unit_t duration = std::chrono::duration_cast<unit_t>(std::chrono::seconds(1)) / 60;
+	void present(slots::graphics::Frame& _frame)
+	{
+		if (!options.record)
+			return;
 
-		point_t start;
-		point_t end;
-		unit_t  delta;
-	} time;
+		const auto& submission = _frame.submission();
+		slots::metrics::registry().display(submission.commands, submission.common, submission.skipped);
+		frame++;
 
-	sdl::Event          event;
-	slots::Interface    interface;
-	slots::StateMachine state_machine;
+		if (!file || submission.skipped)
+			return;
+		std::fprintf(file, "frame %zu: %zu commands, %zu unchanged\n", frame, submission.commands, submission.common);
+		_frame.display().dump(file);
+	}
+};
+
+// what the simulation thread hands over to the render thread whenever the scene changed
+struct Snapshot
+{
+	slots::graphics::RenderList scene;
 
-	interface.init(_texture_pool);
-	interface.layout(_frame.size);
-	interface.place();
+	Uint32 input  = 0; // timestamp of the newest press reflected by the scene
+	size_t inputs = 0; // presses handled so far
+
+	slots::env::state state = slots::env::state::wait;
+};
+
+// a clip is cut once the first frame of a reward is on screen
+void capture(slots::capture::Recorder& _recorder, slots::env::state& _shown, slots::env::state _state)
+{
+	if (_state == slots::env::state::show && _shown != slots::env::state::show)
+		_recorder.mark();
+	_shown = _state;
+}
 
-	state_machine.current()->begin(
+// `_may_idle` lets the loop block on input instead of redrawing an unchanged scene
+void serial(slots::Game& _game, slots::graphics::Frame& _frame, slots::graphics::TexturePool& _texture_pool, slots::capture::Recorder& _recorder, bool _may_idle, slots::Script* _script)
+{
+	Pacing    pacing;
+	Latency   latency;
+	Timing    timing;
+	Recording recording;
+
+	sdl::Event event;
+
+	bool running = true;
+	bool idle    = false;
+	bool redraw  = false;
+	bool settled = true; // the frame did no one-off work, see slots::allocations::frame
+
+	slots::env::state shown = _game.state();
+
+	auto dispatch = [&](const sdl::Event& _event)
+	{
+		if (_event.type == sdl::EventType::SDL_QUIT)
+			running = false;
+		if (_event.type == sdl::EventType::SDL_MOUSEBUTTONDOWN)
+			latency.consume(_event.common.timestamp);
+		if (resized(_event))
+			_texture_pool.prescale();
+		if (damaged(_event))
 		{
-			/*.interface =*/ interface,
+			redraw  = true;
+			settled = false;
+			_frame.invalidate();
 		}
-	);
+		_game.handle(_event);
+	};
+
+	slots::allocations::track("main");
+
+	while (running)
+	{
+		redraw  = !_may_idle;
+		settled = true;
+
+		{
+			slots::allocations::Phase phase(slots::allocations::phase::events);
+
+			if (_script)
+			{
+				_script->woke();
+				_script->drive(_game);
+			}
+
+			if (idle)
+			{
+				timing.pause();
+				if (SDL_WaitEventTimeout(&event, (int)idle_period.count()))
+					dispatch(event);
+				pacing.resume();
+			}
+			else
+				pacing.begin();
+
+			while (SDL_PollEvent(&event))
+				dispatch(event);
+		}
+
+		{
+			slots::allocations::Phase phase(slots::allocations::phase::update);
+			_game.update();
+		}
+
+		{
+			slots::allocations::Phase phase(slots::allocations::phase::prepare);
+
+			if (_texture_pool.refresh())
+			{
+				redraw  = true;
+				settled = false;
+				_frame.invalidate();
+			}
+			redraw |= _game.scene().dirty();
+
+			// nothing on screen would change, so neither draw nor present until something does
+			idle = !redraw;
+			if (idle)
+			{
+				slots::allocations::frame(settled);
+				continue;
+			}
+
+			if (_texture_pool.prepare(_game.scene()))
+				settled = false;
+		}
+
+		{
+			slots::allocations::Phase phase(slots::allocations::phase::draw);
+			_frame.clear(sdl::env::black);
+			_game.draw();
+		}
+
+		{
+			slots::allocations::Phase phase(slots::allocations::phase::present);
+			_frame.present();
+			_game.clean();
+			latency.present();
+			timing.present();
+			recording.present(_frame);
+			capture(_recorder, shown, _game.state());
+			if (_script)
+				_script->presented(_game.state(), _texture_pool);
+		}
+
+		pacing.end();
+		slots::allocations::frame(settled);
+	}
+}
+
+// The simulation ticks at a fixed rate on its own thread and publishes snapshots;
+// the main thread keeps pumping SDL events (it has to) and presents the newest snapshot.
+// A stalled present therefore never delays spin timing, and a slow tick never blocks a present.
+// Ticks that leave the scene unchanged publish nothing; after one of them both threads block
+// until input arrives or the idle period passes.
+void parallel(slots::Game& _game, slots::graphics::Frame& _frame, slots::graphics::TexturePool& _texture_pool, slots::capture::Recorder& _recorder, bool _may_idle, slots::Script* _script)
+{
+	util::Ring<sdl::Event, 256>  events;
+	util::TripleBuffer<Snapshot> snapshots;
+	util::Wakeup                 wakeup;    // lets the simulation sleep through idle ticks until input arrives
+	util::Wakeup                 published; // lets the render thread sleep until a snapshot is published or the simulation idles
 
-	for (bool running = true; running;)
+	std::atomic<bool>  running = {true};
+	std::atomic<bool>  idle    = {false};
+	std::exception_ptr failure;
+
+	// each slot is first written whenever the rotation reaches it, possibly long after the warmup,
+	// so all of them get room for the scene up front
 	{
-		time.start = std::chrono::high_resolution_clock::now();
+		Snapshot initial;
+		initial.scene = _game.scene();
+		initial.state = _game.state();
+		snapshots.fill(initial);
+	}
 
-		while (SDL_PollEvent(&event))
-			switch (event.type)
+	auto simulation = std::thread(
+		[&]()
+		{
+			Pacing     pacing;
+			sdl::Event event;
+
+			Uint32 input  = 0;
+			size_t inputs = 0;
+
+			try
 			{
-			case sdl::EventType::SDL_QUIT:
-				running = false;
-				break;
-			case sdl::EventType::SDL_WINDOWEVENT:
-				if (event.window.event == sdl::win::event::RESIZED)
-					state_machine.current()->scale(
+				slots::allocations::track("simulation");
+
+				while (running.load(std::memory_order_acquire))
+				{
+					{
+						slots::allocations::Phase phase(slots::allocations::phase::events);
+
+						if (idle.load(std::memory_order_relaxed))
+						{
+							wakeup.wait(idle_period);
+							pacing.resume();
+						}
+						else
+							pacing.begin();
+
+						// its presses go through SDL and this ring like real ones, so they arrive a tick or two later
+						if (_script)
+							_script->drive(_game);
+
+						while (events.pop(event))
 						{
-							/*.interface =*/ interface,
-							/*.frame     =*/ _frame,
+							if (event.type == sdl::EventType::SDL_MOUSEBUTTONDOWN)
+							{
+								input = event.common.timestamp;
+								inputs++;
+							}
+							_game.handle(event);
 						}
-					);
-				break;
-			default:
-				state_machine.current()->handle(
+					}
+
 					{
-						/*.interface =*/ interface,
-						/*.event     =*/ event,
+						slots::allocations::Phase phase(slots::allocations::phase::update);
+						_game.update();
 					}
-				);
-				break;
-			}
 
-		state_machine.current()->update(
+					if (_may_idle && !_game.scene().dirty())
+					{
+						// the render thread has to go back to waiting on SDL, where input reaches it
+						if (!idle.exchange(true, std::memory_order_relaxed))
+							published.notify();
+						slots::allocations::frame();
+						continue;
+					}
+					bool woke = idle.exchange(false, std::memory_order_relaxed);
+
+					{
+						slots::allocations::Phase phase(slots::allocations::phase::publish);
+
+						Snapshot& snapshot = snapshots.write();
+						snapshot.scene  = _game.scene();
+						snapshot.input  = input;
+						snapshot.inputs = inputs;
+						snapshot.state  = _game.state();
+						snapshots.publish();
+						published.notify();
+						_game.clean();
+
+						// the render thread may be blocked waiting for input, and this change came without any,
+						// e.g. once the outcome stream is ready
+						if (woke)
+							slots::graphics::wake();
+					}
+
+					pacing.end();
+					slots::allocations::frame();
+				}
+			}
+			catch (...)
 			{
-				/*.interface =*/ interface,
-				/*.frame     =*/ _frame,
+				failure = std::current_exception();
+				running.store(false, std::memory_order_release);
+				published.notify();
 			}
-		);
+		}
+	);
+
+	Latency   latency;
+	Timing    timing;
+	Recording recording;
+	size_t    presented = 0;
+	bool      drawn     = false;
+
+	slots::env::state shown = _game.state();
 
-		_frame.clear(sdl::env::black);
+	sdl::Event event;
 
-		state_machine.current()->draw(
+	auto dispatch = [&](const sdl::Event& _event) -> bool
+	{
+		if (_event.type == sdl::EventType::SDL_QUIT)
+			running.store(false, std::memory_order_release);
+		else if (!events.push(_event))
+			SDL_LogWarn(SDL_LOG_CATEGORY_INPUT, "event queue is full, event %u dropped", _event.type);
+		if (resized(_event))
+			_texture_pool.prescale();
+		return damaged(_event);
+	};
+
+	// the simulation thread has to be joined on every way out, or unwinding past it terminates the process
+	try
+	{
+		slots::allocations::track("render");
+
+		while (running.load(std::memory_order_acquire))
+		{
+			if (_script)
+				_script->woke();
+
+			bool fresh  = snapshots.acquire();
+			bool waited = false;
+			bool redraw = false;
+
+			bool received = false;
 			{
-				/*.interface =*/ interface,
-				/*.frame     =*/ _frame,
+				slots::allocations::Phase phase(slots::allocations::phase::events);
+
+				if (!fresh && idle.load(std::memory_order_relaxed))
+				{
+					timing.pause();
+					if (SDL_WaitEventTimeout(&event, (int)idle_period.count()))
+					{
+						redraw  |= dispatch(event);
+						received = true;
+					}
+					waited = true;
+				}
+
+				while (SDL_PollEvent(&event))
+				{
+					redraw  |= dispatch(event);
+					received = true;
+				}
+				if (received)
+					wakeup.notify();
 			}
-		);
 
-		_frame.present();
+			// polling alone is not a frame, neither for pacing nor for the tracker;
+			// the simulation is ticking, so the next snapshot or its going idle is at most a tick away
+			if (!fresh && !waited)
+			{
+				published.wait(idle_period);
+				continue;
+			}
 
-		bool next = state_machine.current()->end(
+			const Snapshot* snapshot = nullptr;
 			{
-				/*.interface =*/ interface,
+				slots::allocations::Phase phase(slots::allocations::phase::prepare);
+
+				// an unchanged scene is drawn again only for the window or for replaced textures
+				redraw |= _texture_pool.refresh();
+				if (redraw)
+					_frame.invalidate();
+				if (!fresh && !(redraw && drawn))
+				{
+					slots::allocations::frame(!redraw);
+					continue;
+				}
+
+				snapshot = &snapshots.read();
+				if (_texture_pool.prepare(snapshot->scene))
+					redraw = true;
 			}
-		);
 
-		if (next)
-		{
-			state_machine.next();
-			state_machine.current()->begin(
+			{
+				slots::allocations::Phase phase(slots::allocations::phase::draw);
+				_frame.clear(sdl::env::black);
+				_frame.draw(snapshot->scene);
+			}
+
+			{
+				slots::allocations::Phase phase(slots::allocations::phase::present);
+				_frame.present();
+				timing.present();
+				recording.present(_frame);
+				capture(_recorder, shown, snapshot->state);
+				drawn = true;
+				if (_script)
+					_script->presented(snapshot->state, _texture_pool);
+
+				if (snapshot->inputs != presented)
 				{
-					/*.interface =*/ interface,
+					presented = snapshot->inputs;
+					latency.consume(snapshot->input);
+					latency.present();
 				}
-			);
+			}
+
+			// window damage and loaded textures both mark the frame as one-off work
+			slots::allocations::frame(!redraw);
 		}
-		time.end   = std::chrono::high_resolution_clock::now();
-		time.delta = time.end - time.start;
-
-		std::this_thread::sleep_for(
-			std::max(
-				time.duration - time.delta,
-				std::chrono::nanoseconds::zero()
-			)
-		);
 	}
+	catch (...)
+	{
+		running.store(false, std::memory_order_release);
+		wakeup.notify();
+		simulation.join();
+		throw;
+	}
+
+	wakeup.notify();
+	simulation.join();
+
+	if (failure)
+		std::rethrow_exception(failure);
 }
 
-namespace tex
+// Workload for profile-guided builds: the real state machine, reels, evaluation, reward and draw path
+// through the serial loop, on a hidden window with the software renderer, uncapped, without idle waits,
+// audio or the journal. Start is pressed as soon as it is active; every other spin is stopped by the button
+// and the rest run until the spin state stops them, so both ways out of a spin are covered.
+struct Training : slots::Script
 {
-	auto pair(std::string_view _identifier) -> slots::graphics::type::textures::value_type
+	using clock_t = std::chrono::steady_clock;
+
+	size_t              target = 0;
+	std::atomic<size_t> spins  = {0}; // counted where the scene is presented, read where presses are made
+	size_t              frames = 0;
+
+	slots::env::state   previous = slots::env::state::wait;
+	clock_t::time_point started  = {};
+
+	slots::Presser starting;
+	slots::Presser stopping;
+
+	void start(size_t _spins)
+	{
+		target  = _spins;
+		started = clock_t::now();
+	}
+
+	void drive(const slots::Game& _game) override
+	{
+		if (spins >= target)
+			return;
+
+		const slots::Interface& interface = _game.view();
+		starting(interface.start);
+		if (spins % 2)
+			stopping(interface.stop);
+	}
+
+	void presented(slots::env::state _state, const slots::graphics::TexturePool& _texture_pool) override
+	{
+		if (spins >= target)
+			return;
+
+		frames++;
+		if (_state == slots::env::state::show && previous != slots::env::state::show)
+			spins++;
+		previous = _state;
+
+		if (spins < target)
+			return;
+
+		auto elapsed = std::chrono::duration<double>(clock_t::now() - started).count();
+		SDL_Log("training: %zu spins, %zu frames in %.2f s, %.0f frames/s", spins.load(), frames, elapsed, (double)frames / elapsed);
+
+		sdl::Event quit = {};
+		quit.type = sdl::EventType::SDL_QUIT;
+		SDL_PushEvent(&quit);
+	}
+};
+
+// Plays the game as the options ask for, or the benchmark case `_case` measured by `_run` when both are given.
+void loop(slots::graphics::Frame& _frame, slots::graphics::TexturePool& _texture_pool, const slots::bench::Case* _case, slots::bench::Run* _run)
+{
+	std::string_view cabinet  = _case ? _case->cabinet : options.cabinet;
+	bool             may_idle = _case ? _case->type == slots::bench::scenario::idle : options.idle;
+	bool             serially = _case ? _case->threads == 1 : options.single_thread;
+
+	// only these reach the states; everything else is dropped by SDL before it is queued
+	for (Uint32 type : {sdl::EventType::SDL_MOUSEMOTION, sdl::EventType::SDL_MOUSEWHEEL, sdl::EventType::SDL_MOUSEBUTTONUP, sdl::EventType::SDL_FINGERMOTION, sdl::EventType::SDL_TEXTINPUT, sdl::EventType::SDL_TEXTEDITING})
+		SDL_EventState(type, SDL_IGNORE);
+
+	slots::Game game(_frame, _texture_pool, cabinet);
+
+	// scripted runs measure or train the game, not the audio device
+	if (!options.train && !options.soak && !_run)
+	{
+		game.audio().open();
+		for (const auto& name : slots::env::sounds)
+			game.audio().add(snd::path(name));
+		game.audio().start();
+	}
+
+	// training, soak and benchmark spins are not play, so they stay out of the audit journal;
+	// a cabinet asked to keep one never takes a spin it could not record
+	if (!options.train && !options.soak && !_run && !options.journal.empty() && !game.journal().open(options.journal))
+	{
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "no play without the journal %s", options.journal.data());
+		status = 1;
+		return;
+	}
+
+	game.begin();
+
+	if (options.hot_reload)
+		_texture_pool.watch(assets::directory);
+
+	_frame.record(options.record);
+
+	_texture_pool.originals(!options.lod_drop);
+	_texture_pool.prescale();
+
+	slots::metrics::Exporter exporter;
+	if (!options.metrics.empty())
+		exporter.start(options.metrics);
+
+	slots::capture::Recorder recorder;
+	if (!options.capture.empty() && recorder.start(options.capture, _frame.size))
+		_frame.observe(&recorder);
+
+	slots::Script*    script = nullptr;
+	Training          training;
+	slots::soak::Soak soak;
+	if (options.train)
+	{
+		training.start(options.train);
+		script = &training;
+	}
+	else if (options.soak)
+	{
+		soak.start(options.soak);
+		script = &soak;
+	}
+	else if (_run)
+	{
+		_run->start(game, _frame);
+		script = _run;
+	}
+
+	if (serially)
+		serial(game, _frame, _texture_pool, recorder, may_idle, script);
+	else
+		parallel(game, _frame, _texture_pool, recorder, may_idle, script);
+
+	_frame.observe(nullptr);
+
+	if (!soak.intact())
+		status = 1;
+}
+
+// Every scenario on every renderer, window size, cabinet and loop, each combination in its own SDL context,
+// written as one JSON document; a renderer that cannot be created leaves its combinations marked as not run.
+auto benchmark(slots::graphics::WindowData _window_data, const slots::graphics::type::textures& _textures) -> int
+{
+	static constexpr sdl::Point sizes[] = {
+		{/*.x =*/ 1000, /*.y =*/ 600},
+		{/*.x =*/ 1920, /*.y =*/ 1080},
+		{/*.x =*/ 3840, /*.y =*/ 2160},
+	};
+
+	std::vector<slots::bench::Case> cases;
+	for (bool software : {true, false})
+		for (sdl::Point size : sizes)
+			for (const char* cabinet : slots::cabinet::names)
+				for (size_t type = 0; type < slots::bench::scenarios_count; type++)
+					for (size_t threads : {1, 2})
+						cases.push_back({/*.type =*/ (slots::bench::scenario)type, /*.cabinet =*/ cabinet, /*.size =*/ size, /*.software =*/ software, /*.threads =*/ threads});
+
+	std::FILE* file = std::fopen(options.bench.data(), "w");
+	if (!file)
 	{
-		using std::operator""s;
-		return {_identifier.data(), "../assets/"s + _identifier.data() + ".png"};
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s", options.bench.data(), std::strerror(errno));
+		return 1;
 	}
+
+	auto duration = std::chrono::duration_cast<slots::bench::Run::clock_t::duration>(std::chrono::duration<double>(options.bench_seconds));
+
+	std::vector<slots::bench::Result> results;
+	for (const slots::bench::Case& test : cases)
+	{
+		_window_data.rect.w         = test.size.x;
+		_window_data.rect.h         = test.size.y;
+		_window_data.flags.window   = sdl::win::init::HIDDEN;
+		_window_data.flags.renderer = test.software ? sdl::renderer::SOFTWARE : sdl::renderer::ACCELERATED;
+
+		slots::bench::Run run(test, duration);
+		slots::graphics::context(
+			_window_data, _textures,
+			[&](slots::graphics::Frame& _frame, slots::graphics::TexturePool& _texture_pool)
+			{
+				loop(_frame, _texture_pool, &test, &run);
+			}
+		);
+
+		results.push_back(run.outcome());
+	}
+
+	slots::bench::write(file, cases, results, options.bench_seconds);
+	if (std::fclose(file))
+	{
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s", options.bench.data(), std::strerror(errno));
+		return 1;
+	}
+	return 0;
 }
 
 int main(int _argc, char** _argv)
 {
+	using std::operator""sv;
+
+	for (int i = 1; i < _argc; i++)
+		if (_argv[i] == "--late-latch"sv)
+			options.late_latch = true;
+		else if (_argv[i] == "--single-thread"sv)
+			options.single_thread = true;
+		else if (_argv[i] == "--hot-reload"sv)
+			options.hot_reload = true;
+		else if (_argv[i] == "--no-idle"sv)
+			options.idle = false;
+		else if (_argv[i] == "--display-list"sv)
+			options.record = true;
+		else if (_argv[i] == "--dump-frames"sv && i + 1 < _argc)
+		{
+			options.record = true;
+			options.dump   = _argv[++i];
+		}
+		else if (_argv[i] == "--cabinet"sv && i + 1 < _argc)
+			options.cabinet = _argv[++i];
+		else if (_argv[i] == "--train"sv && i + 1 < _argc)
+			options.train = std::strtoull(_argv[++i], nullptr, 10);
+		else if (_argv[i] == "--soak"sv && i + 1 < _argc)
+			options.soak = std::strtoull(_argv[++i], nullptr, 10);
+		else if (_argv[i] == "--bench"sv && i + 1 < _argc)
+			options.bench = _argv[++i];
+		else if (_argv[i] == "--bench-seconds"sv && i + 1 < _argc)
+			options.bench_seconds = std::max(std::strtod(_argv[++i], nullptr), .1);
+		else if (_argv[i] == "--capture"sv && i + 1 < _argc)
+			options.capture = _argv[++i];
+		else if (_argv[i] == "--lod-drop-originals"sv)
+			options.lod_drop = true;
+		else if (_argv[i] == "--metrics"sv && i + 1 < _argc)
+			options.metrics = _argv[++i];
+		else if (_argv[i] == "--journal"sv && i + 1 < _argc)
+			options.journal = _argv[++i];
+		else if (_argv[i] == "--verify-journal"sv && i + 1 < _argc)
+		{
+			auto audit = slots::journal::Journal::verify(_argv[++i]);
+			SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%s: %llu valid records%s%s", _argv[i], (unsigned long long)audit.records, audit.intact ? "" : ", chain broken after them", audit.torn ? ", torn tail" : "");
+			return audit.intact ? 0 : 1;
+		}
+
+	// training plays through the loop that ships, so its profile covers both threads and their hand-off;
+	// the soak script shares its counters between hooks and keeps to the serial loop,
+	// the benchmark picks the loop per case
+	if (options.soak)
+		options.single_thread = true;
+	if (options.train || options.soak || !options.bench.empty())
+		options.uncapped = true;
+	// training and the soak have to keep drawing; the benchmark decides per scenario
+	if (options.train || options.soak)
+		options.idle = false;
+
+	if (!slots::reels(options.cabinet))
+	{
+		std::string known;
+		for (const char* name : slots::cabinet::names)
+			known += std::string(known.empty() ? "" : ", ") + name;
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "unknown cabinet %s, compiled in: %s", options.cabinet.data(), known.data());
+		return 1;
+	}
+
 	auto window_data = slots::graphics::WindowData{
 		/*.title =*/ "Slots",
 		/*.rect  =*/ {/*.x =*/ 200, /*.y =*/ 200, /*.w =*/ 1000, /*.h =*/ 600},
@@ -134,6 +885,14 @@ int main(int _argc, char** _argv)
 		},
 	};
 
+	// nothing of the training or soak run is shown, and the software renderer behaves the same everywhere
+	if (options.train || options.soak)
+	{
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		window_data.flags.window   = sdl::win::init::HIDDEN;
+		window_data.flags.renderer = sdl::renderer::SOFTWARE;
+	}
+
 	auto textures = slots::graphics::type::textures();
 
 	for (const auto& name : slots::env::cats)
@@ -145,7 +904,16 @@ int main(int _argc, char** _argv)
 	for (const auto& name : slots::env::buttons)
 		textures.insert(tex::pair(name));
 
-	slots::graphics::context(window_data, textures, loop);
+	if (!options.bench.empty())
+		return benchmark(window_data, textures);
 
-	return 0;
+	slots::graphics::context(
+		window_data, textures,
+		[](slots::graphics::Frame& _frame, slots::graphics::TexturePool& _texture_pool)
+		{
+			loop(_frame, _texture_pool, nullptr, nullptr);
+		}
+	);
+
+	return status;
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "bindings.h"
+#include "states.h"
+#include "metrics.h"
+
+#include <SDL_log.h>
+#include <filesystem>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <array>
+#include <cstdio>
+
+namespace slots::metrics
+{
+	void Histogram::observe(Uint64 _value)
+	{
+		size_t index = std::lower_bound(bounds.begin(), bounds.end(), _value) - bounds.begin();
+		counts[index].add();
+		sum.add(_value);
+	}
+
+	auto Histogram::bound(size_t _index) const -> Uint64
+	{
+		return bounds[_index];
+	}
+
+	auto Histogram::count(size_t _index) const -> Uint64
+	{
+		return counts[_index].load();
+	}
+
+	auto Histogram::total() const -> Uint64
+	{
+		Uint64 total = 0;
+		for (const Counter& count : counts)
+			total += count.load();
+		return total;
+	}
+
+	auto Histogram::accumulated() const -> Uint64
+	{
+		return sum.load();
+	}
+
+	auto Histogram::quantile(double _quantile) const -> double
+	{
+		// one pass over a copy, so the buckets agree with each other while the loop keeps recording
+		std::array<Uint64, bounds_count + 1> snapshot;
+		Uint64 total = 0;
+		for (size_t i = 0; i < snapshot.size(); i++)
+			total += snapshot[i] = counts[i].load();
+
+		if (!total)
+			return 0.;
+
+		double target = _quantile * (double)total;
+		Uint64 below  = 0;
+		for (size_t i = 0; i < snapshot.size(); i++)
+		{
+			if ((double)(below + snapshot[i]) < target || !snapshot[i])
+			{
+				below += snapshot[i];
+				continue;
+			}
+			double lower = i ? (double)bounds[i - 1] : 0.;
+			if (i == bounds_count)
+				return lower;
+			double upper = (double)bounds[i];
+			return lower + (upper - lower) * (target - (double)below) / (double)snapshot[i];
+		}
+		return (double)bounds.back();
+	}
+
+	// -----------------------------------------
+
+	void Registry::state(env::state _state, unit_t _elapsed)
+	{
+		size_t index = static_cast<env::state_t>(_state);
+		if (index >= states_count)
+			return;
+		entered[index].add();
+		elapsed[index].add(_elapsed.count());
+	}
+
+	void Registry::frame(unit_t _elapsed, unit_t _budget)
+	{
+		frames.add();
+		frame_time.observe(_elapsed.count());
+
+		// every whole budget past the first is a refresh the display showed twice
+		auto missed = (_elapsed + _budget / 2) / _budget;
+		if (missed > 1)
+			dropped.add(missed - 1);
+	}
+
+	void Registry::display(size_t _commands, size_t _unchanged, bool _skipped)
+	{
+		commands.add(_commands);
+		unchanged.add(_unchanged);
+		if (_skipped)
+			skipped.add();
+	}
+
+	auto registry() -> Registry&
+	{
+		static auto registry = Registry();
+		return registry;
+	}
+
+	// -----------------------------------------
+
+	namespace
+	{
+		constexpr const char* names[Registry::states_count] = {
+			"wait", "accelerate", "spin", "decelerate", "show",
+		};
+
+		constexpr double seconds = 1e-9;
+
+		void header(std::ostream& _stream, const char* _name, const char* _type, const char* _help)
+		{
+			_stream << "# HELP " << _name << ' ' << _help << '\n';
+			_stream << "# TYPE " << _name << ' ' << _type << '\n';
+		}
+
+		// The shortest fixed-point text that reads back as the same double: the default six significant
+		// digits of a stream would round large sums and switch them to an exponent.
+		struct Number
+		{
+			double value;
+		};
+
+		auto operator<<(std::ostream& _stream, Number _number) -> std::ostream&
+		{
+			std::array<char, 512> buffer;
+			auto [end, error] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), _number.value, std::chars_format::fixed);
+			if (error != std::errc())
+				return _stream << _number.value;
+			return _stream.write(buffer.data(), end - buffer.data());
+		}
+	}
+
+	auto format(const Registry& _registry) -> std::string
+	{
+		std::ostringstream stream;
+
+		header(stream, "slots_spins_total", "counter", "Spins started.");
+		stream << "slots_spins_total " << _registry.spins.load() << '\n';
+
+		header(stream, "slots_reward_paid_total", "counter", "Sum of every shown reward value.");
+		stream << "slots_reward_paid_total " << _registry.paid.load() << '\n';
+
+		header(stream, "slots_play_halted", "gauge", "1 once play halted for good: the outcome stream failed a health test, or the journal could not keep a record.");
+		stream << "slots_play_halted{cause=\"outcome_stream\"} " << (int)_registry.halted[Registry::stream].load(std::memory_order_relaxed) << '\n';
+		stream << "slots_play_halted{cause=\"journal\"} " << (int)_registry.halted[Registry::journal].load(std::memory_order_relaxed) << '\n';
+
+		header(stream, "slots_spins_refused_total", "counter", "Presses of start ignored while play is halted.");
+		stream << "slots_spins_refused_total " << _registry.refused.load() << '\n';
+
+		header(stream, "slots_state_entered_total", "counter", "Times each state of the machine was entered.");
+		for (size_t i = 0; i < Registry::states_count; i++)
+			stream << "slots_state_entered_total{state=\"" << names[i] << "\"} " << _registry.entered[i].load() << '\n';
+
+		header(stream, "slots_state_seconds_total", "counter", "Time spent in each state, counted when the state ends.");
+		for (size_t i = 0; i < Registry::states_count; i++)
+			stream << "slots_state_seconds_total{state=\"" << names[i] << "\"} " << Number{(double)_registry.elapsed[i].load() * seconds} << '\n';
+
+		header(stream, "slots_frames_total", "counter", "Frames presented.");
+		stream << "slots_frames_total " << _registry.frames.load() << '\n';
+
+		header(stream, "slots_frames_dropped_total", "counter", "Refresh intervals missed between presents.");
+		stream << "slots_frames_dropped_total " << _registry.dropped.load() << '\n';
+
+		header(stream, "slots_display_commands_total", "counter", "Draw commands recorded into display lists.");
+		stream << "slots_display_commands_total " << _registry.commands.load() << '\n';
+
+		header(stream, "slots_display_commands_unchanged_total", "counter", "Recorded draw commands equal to the ones of the previous frame.");
+		stream << "slots_display_commands_unchanged_total " << _registry.unchanged.load() << '\n';
+
+		header(stream, "slots_display_skipped_total", "counter", "Presents skipped because the display list did not change.");
+		stream << "slots_display_skipped_total " << _registry.skipped.load() << '\n';
+
+		const Histogram& histogram = _registry.frame_time;
+
+		header(stream, "slots_frame_seconds", "histogram", "Time between consecutive presents.");
+		Uint64 cumulative = 0;
+		for (size_t i = 0; i < Histogram::bounds_count; i++)
+		{
+			cumulative += histogram.count(i);
+			stream << "slots_frame_seconds_bucket{le=\"" << Number{(double)histogram.bound(i) * seconds} << "\"} " << cumulative << '\n';
+		}
+		cumulative += histogram.count(Histogram::bounds_count);
+		stream << "slots_frame_seconds_bucket{le=\"+Inf\"} " << cumulative << '\n';
+		stream << "slots_frame_seconds_sum " << Number{(double)histogram.accumulated() * seconds} << '\n';
+		stream << "slots_frame_seconds_count " << cumulative << '\n';
+
+		header(stream, "slots_frame_seconds_quantile", "gauge", "Frame time percentiles estimated from the histogram buckets.");
+		for (double quantile : {0.5, 0.9, 0.99, 0.999})
+			stream << "slots_frame_seconds_quantile{quantile=\"" << Number{quantile} << "\"} " << Number{histogram.quantile(quantile) * seconds} << '\n';
+
+		return stream.str();
+	}
+
+	// -----------------------------------------
+
+	Exporter::~Exporter()
+	{
+		stop();
+	}
+
+	void Exporter::start(std::string_view _path, std::chrono::milliseconds _period)
+	{
+		if (writer.joinable())
+			return;
+		path    = _path;
+		period  = _period;
+		running = true;
+		writer  = std::thread(&Exporter::run, this);
+	}
+
+	void Exporter::stop()
+	{
+		if (!writer.joinable())
+			return;
+		running = false;
+		writer.join();
+		write();
+	}
+
+	void Exporter::run()
+	{
+		const auto step = std::chrono::milliseconds(100);
+
+		for (auto next = std::chrono::steady_clock::now(); running; std::this_thread::sleep_for(step))
+		{
+			if (std::chrono::steady_clock::now() < next)
+				continue;
+			next += period;
+			write();
+		}
+	}
+
+	bool Exporter::write() const
+	{
+		std::string temporary = path + ".tmp";
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			file << format(registry());
+			if (!file)
+			{
+				SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "metrics: cannot write %s", temporary.data());
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporary, path, error);
+		if (error)
+		{
+			SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "metrics: %s: %s", path.data(), error.message().data());
+			return false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "bindings.h"
+#include "graphics.h"
+#include "interface.h"
+#include "states.h"
+#include "game.h"
+#include "soak.h"
+
+#include <SDL_log.h>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace slots::soak
+{
+	namespace
+	{
+		constexpr const char* names[Soak::states_count] = {
+			"wait", "accelerate", "spin", "decelerate", "show",
+		};
+
+		constexpr double mebibyte = 1024. * 1024.;
+	}
+
+	auto resident() -> size_t
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters = {};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+			return counters.WorkingSetSize;
+		return 0;
+#elif defined(__APPLE__)
+		mach_task_basic_info_data_t info = {};
+		mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+		if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+			return info.resident_size;
+		return 0;
+#elif defined(__linux__)
+		// the second field of statm is the resident set, in pages
+		std::FILE* file = std::fopen("/proc/self/statm", "r");
+		if (!file)
+			return 0;
+		unsigned long long size = 0, pages = 0;
+		int read = std::fscanf(file, "%llu %llu", &size, &pages);
+		std::fclose(file);
+		return read == 2 ? (size_t)pages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+#else
+		return 0;
+#endif
+	}
+
+	void Soak::start(size_t _spins)
+	{
+		target = _spins;
+
+		samples.assign(samples_count, 0);
+		sorted.reserve(samples_count);
+
+		started = reported = last = clock_t::now();
+
+		// reports have to show in release builds too, where everything below errors is filtered out
+		SDL_LogSetPriority(SDL_LOG_CATEGORY_TEST, SDL_LOG_PRIORITY_INFO);
+		SDL_LogInfo(SDL_LOG_CATEGORY_TEST, "soak: %zu spins, a report every %llds", target, (long long)period.count());
+	}
+
+	bool Soak::active() const
+	{
+		return target != 0;
+	}
+
+	bool Soak::intact() const
+	{
+		return drifts == 0;
+	}
+
+	void Soak::drive(const Game& _game)
+	{
+		if (!active())
+			return;
+
+		// the game stands as it was presented last, since nothing was handled or updated after that;
+		// every reel has to stand on its resolved stop by the time the win is shown
+		env::state state = _game.state();
+		check(_game, state == env::state::show && checked != env::state::show);
+		checked = state;
+
+		const Interface& interface = _game.view();
+		if (interface.start.active() && !interface.start.pressed())
+			press(interface.start);
+
+		// half of the spins are stopped by the button, after a delay that differs from spin to spin;
+		// the rest run until the spin state stops them
+		if (!interface.stop.active() || interface.stop.pressed())
+		{
+			waiting = 0;
+			return;
+		}
+		if (spins % 2 && waiting++ == spins / 2 % 32)
+			press(interface.stop);
+	}
+
+	void Soak::check(const Game& _game, bool _landed)
+	{
+		Reels::Drift drift = _game.view().barrels->drift(_landed);
+		if (!drift.what)
+			return;
+
+		// a broken reel stays broken, so only the first few frames of it are worth a line each
+		if (drifts++ < 16)
+			SDL_LogError(SDL_LOG_CATEGORY_TEST, "soak: spin %zu, frame %llu, reel %zu: %s", spins, (unsigned long long)frames, drift.reel, drift.what);
+	}
+
+	void Soak::presented(env::state _state, const graphics::TexturePool& _texture_pool)
+	{
+		if (!active())
+			return;
+
+		clock_t::time_point now = clock_t::now();
+		auto elapsed = (Uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+		last = now;
+
+		samples[sampled++ % samples_count] = (Uint32)std::min<Uint64>(elapsed, std::numeric_limits<Uint32>::max());
+		slowest = std::max(slowest, elapsed);
+		frames++;
+
+		if (_state != previous)
+		{
+			entered[static_cast<env::state_t>(_state)]++;
+			if (_state == env::state::show)
+				spins++;
+		}
+		previous = _state;
+
+		bool done = spins >= target;
+		if (done || now - reported >= period)
+			report(_texture_pool);
+
+		if (done)
+		{
+			SDL_LogInfo(SDL_LOG_CATEGORY_TEST, "soak: %s after %zu spins, %zu frames with drifting reels", intact() ? "passed" : "FAILED", spins, drifts);
+			target = 0;
+
+			sdl::Event quit = {};
+			quit.type = sdl::EventType::SDL_QUIT;
+			SDL_PushEvent(&quit);
+		}
+	}
+
+	void Soak::report(const graphics::TexturePool& _texture_pool)
+	{
+		clock_t::time_point now = clock_t::now();
+
+		size_t memory   = resident();
+		size_t textures = _texture_pool.textures();
+		if (reported == started)
+		{
+			resident_baseline = memory;
+			textures_baseline = textures;
+		}
+
+		size_t count = (size_t)std::min<Uint64>(sampled, samples_count);
+		sorted.assign(samples.begin(), samples.begin() + count);
+		auto percentile = [&](double _fraction) -> double
+		{
+			if (sorted.empty())
+				return 0;
+			auto nth = sorted.begin() + (ptrdiff_t)std::min(count - 1, (size_t)(_fraction * count));
+			std::nth_element(sorted.begin(), nth, sorted.end());
+			return *nth / 1e3;
+		};
+		double p50  = percentile(.5);
+		double p99  = percentile(.99);
+		double p999 = percentile(.999);
+
+		auto seconds = std::chrono::duration<double>(now - started).count();
+		SDL_LogInfo(
+			SDL_LOG_CATEGORY_TEST,
+			"soak: %.0fs, %zu spins, %llu frames, %.0f frames/s; rss %.1f MiB (%+.1f); textures %zu (%+lld); frame us p50 %.1f p99 %.1f p99.9 %.1f max %.1f; drifting frames %zu",
+			seconds, spins, (unsigned long long)frames, frames / std::max(seconds, 1e-9),
+			memory / mebibyte, ((double)memory - (double)resident_baseline) / mebibyte,
+			textures, (long long)textures - (long long)textures_baseline,
+			p50, p99, p999, slowest / 1e3,
+			drifts
+		);
+		SDL_LogInfo(
+			SDL_LOG_CATEGORY_TEST,
+			"soak: entered %s %llu, %s %llu, %s %llu, %s %llu, %s %llu",
+			names[0], (unsigned long long)entered[0], names[1], (unsigned long long)entered[1], names[2], (unsigned long long)entered[2],
+			names[3], (unsigned long long)entered[3], names[4], (unsigned long long)entered[4]
+		);
+
+		// the slowest frame and the percentiles cover one report each
+		slowest  = 0;
+		sampled  = 0;
+		reported = now;
+	}
+}
\ No newline at end of file
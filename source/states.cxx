@@ -4,9 +4,15 @@
 #include "elements.h"
 #include "states.h"
 #include "lists.h"
+#include "metrics.h"
+#include "journal.h"
 
+#include <SDL_log.h>
 #include <algorithm>
 #include <iterator>
+#include <cstring>
+#include <chrono>
+#include <array>
 
 namespace slots::env
 {
@@ -32,9 +38,24 @@ namespace slots
 {
 
 	void State::scale(Scale _data)
+	{
+		auto [interface, scale] = _data;
+		interface.scale(scale);
+	}
+
+	void State::draw(Draw _data)
 	{
 		auto [interface, frame] = _data;
-		interface.scale(frame.scaling());
+		frame.draw(interface.scene);
+	}
+
+	void State::prefetch(Prefetch _data)
+	{
+		// whatever the scene already points at, hidden records included, is likely drawn next
+		auto [interface, texture_pool] = _data;
+		for (const graphics::Record& record : interface.scene)
+			if (record.type == graphics::Record::kind::sprite)
+				texture_pool.prefetch(record.ptr);
 	}
 
 	// -----------------------------------------
@@ -43,6 +64,7 @@ namespace slots
 	{
 		auto [interface] = _data;
 		interface.reward.value = 0;
+		interface.reward.hide();
 		interface.start.reset();
 		interface.stop.reset();
 		interface.start.activate();
@@ -58,7 +80,11 @@ namespace slots
 		case sdl::EventType::SDL_MOUSEBUTTONDOWN:
 			mouse = slots::graphics::motion(event);
 			if (interface.start.contains(mouse))
+			{
 				interface.start.press();
+				if (!interface.entropy.healthy() || interface.journal.failed())
+					metrics::registry().refused.add();
+			}
 			break;
 		default:
 			break;
@@ -68,20 +94,23 @@ namespace slots
 	void Wait::update(Update _data)
 	{
 		auto [interface, frame] = _data;
-		frame.update(interface.barrels, interface.start, interface.stop);
+		interface.update();
 		updated++;
-	}
 
-	void Wait::draw(Draw _data)
-	{
-		auto [interface, frame] = _data;
-		frame.draw(interface.barrels, interface.start, interface.stop);
+		// neither the stream nor the journal recovers, so each halt is reported once, with the cause logged where it happened
+		auto& halted = metrics::registry().halted;
+		if (!interface.entropy.healthy() && !halted[metrics::Registry::stream].exchange(true, std::memory_order_relaxed))
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "play halted: the outcome stream stopped, the cabinet has to be restarted");
+		if (interface.journal.failed() && !halted[metrics::Registry::journal].exchange(true, std::memory_order_relaxed))
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "play halted: the journal lost a record, the cabinet has to be restarted");
 	}
 
 	bool Wait::end(End _data)
 	{
 		auto [interface] = _data;
-		return interface.start.pressed();
+		// a spin only starts with its outcome ready, which also keeps play stopped if the entropy source fails,
+		// and only while every spin is still recorded
+		return interface.start.pressed() && interface.entropy.ready(interface.barrels->count()) && !interface.journal.failed();
 	}
 
 	// -----------------------------------------
@@ -89,6 +118,11 @@ namespace slots
 	void Accelerate::begin(Begin _data)
 	{
 		auto [interface] = _data;
+		auto words = std::array<Uint64, Reels::capacity>();
+		interface.entropy.take(words.data(), interface.barrels->count());
+		interface.barrels->resolve(words.data());
+		interface.audio.play(env::sound::spin, true);
+		metrics::registry().spins.add();
 		interface.start.reset();
 		updated = 0;
 	}
@@ -104,23 +138,17 @@ namespace slots
 	{
 		auto [interface, frame] = _data;
 
-		interface.barrels.accelerate();
-		interface.barrels.spin();
+		interface.barrels->accelerate();
+		interface.barrels->spin();
 
-		frame.update(interface.barrels, interface.start, interface.stop);
+		interface.update();
 		updated++;
 	}
 
-	void Accelerate::draw(Draw _data)
-	{
-		auto [interface, frame] = _data;
-		frame.draw(interface.barrels, interface.start, interface.stop);
-	}
-
 	bool Accelerate::end(End _data)
 	{
 		auto [interface] = _data;
-		return interface.barrels.accelerated();
+		return interface.barrels->accelerated();
 	}
 
 	// -----------------------------------------
@@ -154,21 +182,15 @@ namespace slots
 	{
 		auto [interface, frame] = _data;
 
-		interface.barrels.spin();
+		interface.barrels->spin();
 
 		if (updated == threshold)
 			interface.stop.press();
 
-		frame.update(interface.barrels, interface.start, interface.stop);
+		interface.update();
 		updated++;
 	}
 
-	void Spin::draw(Draw _data)
-	{
-		auto [interface, frame] = _data;
-		frame.draw(interface.barrels, interface.start, interface.stop);
-	}
-
 	bool Spin::end(End _data)
 	{
 		auto [interface] = _data;
@@ -194,23 +216,23 @@ namespace slots
 	{
 		auto [interface, frame] = _data;
 
-		interface.barrels.decelerate();
-		interface.barrels.spin();
+		size_t halted = interface.barrels->halted();
 
-		frame.update(interface.barrels, interface.start, interface.stop);
-		updated++;
-	}
+		interface.barrels->decelerate();
+		interface.barrels->spin();
 
-	void Decelerate::draw(Draw _data)
-	{
-		auto [interface, frame] = _data;
-		frame.draw(interface.barrels, interface.start, interface.stop);
+		// the click is queued in the same update that stops the reel, ahead of its present
+		for (size_t i = halted; i < interface.barrels->halted(); i++)
+			interface.audio.play(env::sound::click);
+
+		interface.update();
+		updated++;
 	}
 
 	bool Decelerate::end(End _data)
 	{
 		auto [interface] = _data;
-		return interface.barrels.stopped();
+		return interface.barrels->stopped();
 	}
 
 	// -----------------------------------------
@@ -219,15 +241,34 @@ namespace slots
 	{
 		auto [interface] = _data;
 
-		size_t count[env::cats.size()] = {};
-		for (const auto& barrel : interface.barrels.array)
-			count[barrel.symbol()]++;
-
-		auto*  elem = std::max_element(std::begin(count), std::end(count));
-		size_t id   = std::distance(std::begin(count), elem);
-
-
-		interface.reward.value = std::pow(*elem, id) * Reward::multiplier;
+		// every line pays count^symbol units, so rarer cats and longer runs are worth more
+		auto pay = [](size_t _symbol, size_t _count) -> Uint64
+		{
+			Uint64 units = 1;
+			for (size_t i = 0; i < _symbol; i++)
+				units *= _count;
+			return units * Reward::multiplier;
+		};
+
+		auto result = interface.barrels->evaluate(pay);
+
+		interface.reward.value = result.total;
+		interface.reward.show();
+		metrics::registry().paid.add(interface.reward.value);
+
+		journal::Entry entry;
+		entry.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		entry.reward    = interface.reward.value;
+		std::strncpy(entry.cabinet.data(), interface.barrels->name(), entry.cabinet.size());
+		entry.strips = interface.barrels->fingerprint();
+		for (size_t reel = 0; reel < interface.barrels->count() && entry.count < journal::Entry::capacity; reel++)
+			entry.stops[entry.count++] = (Uint16)interface.barrels->stop(reel);
+		// a record the journal cannot take fails it, and Wait refuses every spin after this one
+		interface.journal.append(entry);
+
+		interface.audio.stop(env::sound::spin);
+		if (interface.reward.value)
+			interface.audio.play(env::sound::win);
 
 		interface.start.reset();
 		interface.stop.reset();
@@ -256,22 +297,24 @@ namespace slots
 	void Show::update(Update _data)
 	{
 		auto [interface, frame] = _data;
-		frame.update(interface.barrels, interface.start, interface.stop, interface.reward);
+		interface.update();
 		updated++;
 	}
 
-	void Show::draw(Draw _data)
-	{
-		auto [interface, frame] = _data;
-		frame.draw(interface.barrels, interface.start, interface.stop, interface.reward);
-	}
-
 	bool Show::end(End _data)
 	{
 		auto [interface] = _data;
+		// Wait, which comes next, holds the spin back until the outcome is ready
 		return interface.start.pressed();
 	}
 
+	void Show::prefetch(Prefetch _data)
+	{
+		State::prefetch(_data);
+		auto [interface, texture_pool] = _data;
+		interface.reward.prefetch(texture_pool);
+	}
+
 	// -----------------------------------------
 
 		namespace st
@@ -323,6 +366,19 @@ namespace slots
 		return nullptr;
 	}
 
+	auto StateMachine::upcoming() const -> State*
+	{
+		env::state following = state;
+		if (util::contains(states, ++following))
+			return states.at(following);
+		return nullptr;
+	}
+
+	auto StateMachine::type() const -> env::state
+	{
+		return state;
+	}
+
 	void StateMachine::next()
 	{
 		state++;
@@ -1,7 +1,65 @@
 #include "utility.h"
 
+#include <stdexcept>
+#include <limits>
+
 namespace util
 {
+	void Alias::assign(const Uint32* _weights, size_t _count)
+	{
+		Uint64 sum = 0;
+		for (size_t i = 0; i < _count; i++)
+			sum += _weights[i];
+
+		if (_count == 0 || sum == 0 || sum > std::numeric_limits<Uint32>::max())
+			throw std::invalid_argument("alias table weights must be non-zero and fit into 32 bits");
+
+		total = (Uint32)sum;
+		threshold.assign(_count, total);
+		alias.resize(_count);
+
+		// every column holds exactly `total` units once the table is built
+		auto scaled = std::vector<Uint64>(_count);
+		auto small  = std::vector<size_t>();
+		auto large  = std::vector<size_t>();
+
+		for (size_t i = 0; i < _count; i++)
+		{
+			alias[i]  = (Uint32)i;
+			scaled[i] = (Uint64)_weights[i] * _count;
+			(scaled[i] < total ? small : large).push_back(i);
+		}
+
+		while (!small.empty() && !large.empty())
+		{
+			size_t less = small.back();
+			size_t more = large.back();
+			small.pop_back();
+
+			threshold[less] = (Uint32)scaled[less];
+			alias[less]     = (Uint32)more;
+
+			scaled[more] -= total - scaled[less];
+			if (scaled[more] < total)
+			{
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+	}
+
+	auto Alias::size() const -> size_t
+	{
+		return threshold.size();
+	}
+
+	auto Alias::operator()(Uint64 _entropy) const -> size_t
+	{
+		size_t column = (size_t)(((_entropy >> 32) * threshold.size()) >> 32);
+		Uint32 point  = (Uint32)(((_entropy & 0xFFFFFFFF) * total) >> 32);
+		return point < threshold[column] ? column : alias[column];
+	}
+
 	auto operator+(sdl::FPoint _p1, sdl::FPoint _p2) -> sdl::FPoint
 	{
 		return {/*.x =*/ _p1.x + _p2.x, /*.y =*/ _p1.y + _p2.y};